@@ -0,0 +1,959 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <malloc.h>
+
+#include <benchmark/benchmark.h>
+#include <radix_tree.hpp>
+#include <radix_tree_burst.hpp>
+#include <radix_tree_cache.hpp>
+#include <radix_tree_dictionary.hpp>
+#include <radix_tree_static.hpp>
+#include <radix_tree_suffix.hpp>
+
+#include "datasets.hpp"
+
+// live heap bytes, as seen by the allocator, for the memory-per-key measurements
+static std::atomic<std::size_t> g_heap_bytes{0};
+
+void* operator new(const std::size_t size) {
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    g_heap_bytes.fetch_add(malloc_usable_size(p), std::memory_order_relaxed);
+    return p;
+}
+
+void* operator new[](const std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    if (p != nullptr) {
+        g_heap_bytes.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+namespace {
+
+// Every container is driven through the same small interface. An adapter without an operation does
+// not get the corresponding benchmark.
+
+struct radix_tree_adapter {
+    static constexpr const char* name = "radix_tree";
+
+    radix_tree<std::string, int> c;
+    std::vector<radix_tree<std::string, int>::iterator> found;
+
+    void insert(const std::string& key, const int value) { c.insert(std::make_pair(key, value)); }
+    void done() {}
+    bool find(const std::string& key) { return c.find(key) != c.end(); }
+    bool erase(const std::string& key) { return c.erase(key); }
+    bool longest_match(const std::string& key) { return c.longest_match(key) != c.end(); }
+    std::size_t prefix_match(const std::string& key) {
+        c.prefix_match(key, found);
+        return found.size();
+    }
+    long iterate() {
+        long sum = 0;
+        for (auto it = c.begin(); it != c.end(); ++it) {
+            sum += it->second;
+        }
+        return sum;
+    }
+    std::size_t estimated_bytes() const { return c.stats().heap_bytes; }
+};
+
+// the same tree with the hash side-index, to weigh faster exact lookups against memory and insert cost
+struct radix_tree_hash_index_adapter : radix_tree_adapter {
+    static constexpr const char* name = "radix_tree_hash_index";
+
+    radix_tree_hash_index_adapter() { c.enable_hash_index(); }
+};
+
+// the same tree with a Bloom filter, which pays off when most lookups miss
+struct radix_tree_bloom_adapter : radix_tree_adapter {
+    static constexpr const char* name = "radix_tree_bloom";
+
+    radix_tree_bloom_adapter() { c.enable_bloom_filter(0.01); }
+};
+
+// the same tree behind a lookup cache, which pays off on skewed query streams
+struct radix_tree_cached_adapter : radix_tree_adapter {
+    static constexpr const char* name = "radix_tree_cached";
+
+    radix_lookup_cache<radix_tree<std::string, int>> cache{c, 4096};
+
+    bool find(const std::string& key) { return cache.find(key) != c.end(); }
+    bool longest_match(const std::string& key) { return cache.longest_match(key) != c.end(); }
+};
+
+// the burst trie, which trades the nodes of small subtrees for packed sorted buckets
+struct radix_burst_tree_adapter {
+    static constexpr const char* name = "radix_burst_tree";
+
+    radix_burst_tree<std::string, int> c;
+
+    void insert(const std::string& key, const int value) { c.insert({key, value}); }
+    void done() {}
+    bool find(const std::string& key) { return c.find(key) != c.end(); }
+    bool erase(const std::string& key) { return c.erase(key); }
+    bool longest_match(const std::string& key) { return c.longest_match(key) != c.end(); }
+    long iterate() {
+        long sum = 0;
+        for (auto it = c.begin(); it != c.end(); ++it) {
+            sum += it->second;
+        }
+        return sum;
+    }
+    std::size_t estimated_bytes() const { return c.stats().heap_bytes; }
+};
+
+struct std_map_adapter {
+    static constexpr const char* name = "std_map";
+
+    std::map<std::string, int, std::less<>> c;
+
+    void insert(const std::string& key, const int value) { c.emplace(key, value); }
+    void done() {}
+    bool find(const std::string& key) { return c.find(key) != c.end(); }
+    bool erase(const std::string& key) { return c.erase(key) != 0; }
+    bool longest_match(const std::string& key) {
+        for (std::size_t len = key.size() + 1; len-- > 0;) {
+            if (c.find(std::string_view(key).substr(0, len)) != c.end()) {
+                return true;
+            }
+        }
+        return false;
+    }
+    std::size_t prefix_match(const std::string& key) {
+        std::size_t n = 0;
+        for (auto it = c.lower_bound(key); it != c.end() && it->first.starts_with(key); ++it) {
+            n++;
+        }
+        return n;
+    }
+    long iterate() {
+        long sum = 0;
+        for (const auto& [key, value] : c) {
+            sum += value;
+        }
+        return sum;
+    }
+};
+
+struct string_hash {
+    using is_transparent = void;
+    std::size_t operator()(const std::string_view key) const { return std::hash<std::string_view>()(key); }
+};
+
+struct std_unordered_map_adapter {
+    static constexpr const char* name = "std_unordered_map";
+
+    std::unordered_map<std::string, int, string_hash, std::equal_to<>> c;
+
+    void insert(const std::string& key, const int value) { c.emplace(key, value); }
+    void done() {}
+    bool find(const std::string& key) { return c.find(key) != c.end(); }
+    bool erase(const std::string& key) { return c.erase(key) != 0; }
+    bool longest_match(const std::string& key) {
+        for (std::size_t len = key.size() + 1; len-- > 0;) {
+            if (c.find(std::string_view(key).substr(0, len)) != c.end()) {
+                return true;
+            }
+        }
+        return false;
+    }
+    // prefix_match has no better answer than a full scan here
+    long iterate() {
+        long sum = 0;
+        for (const auto& [key, value] : c) {
+            sum += value;
+        }
+        return sum;
+    }
+};
+
+// a static structure: built once by sorting, so it has no erase
+struct sorted_vector_adapter {
+    static constexpr const char* name = "sorted_vector";
+
+    std::vector<std::pair<std::string, int>> c;
+
+    void insert(const std::string& key, const int value) { c.emplace_back(key, value); }
+    void done() { std::ranges::sort(c); }
+    auto lower_bound(const std::string_view key) const {
+        return std::ranges::lower_bound(c, key, std::less<>(), [](const auto& kv) { return std::string_view(kv.first); });
+    }
+    bool find(const std::string& key) {
+        const auto it = lower_bound(key);
+        return it != c.end() && it->first == key;
+    }
+    bool longest_match(const std::string& key) {
+        for (std::size_t len = key.size() + 1; len-- > 0;) {
+            const std::string_view prefix = std::string_view(key).substr(0, len);
+            const auto it = lower_bound(prefix);
+            if (it != c.end() && it->first == prefix) {
+                return true;
+            }
+        }
+        return false;
+    }
+    std::size_t prefix_match(const std::string& key) {
+        std::size_t n = 0;
+        for (auto it = lower_bound(key); it != c.end() && it->first.starts_with(key); ++it) {
+            n++;
+        }
+        return n;
+    }
+    long iterate() {
+        long sum = 0;
+        for (const auto& [key, value] : c) {
+            sum += value;
+        }
+        return sum;
+    }
+};
+
+// operations on large sets are timed on a sample of at most this many keys
+constexpr std::size_t max_queries = 1'000'000;
+
+struct data {
+    std::vector<std::string> keys;
+    std::vector<std::string> longest_match_queries;
+    std::vector<std::string> prefix_queries;
+    // longest_match queries where a few thousand distinct ones make up most of the stream
+    std::vector<std::string> skewed_queries;
+    // find queries that mostly miss
+    std::vector<std::string> miss_queries;
+};
+
+const data& get_data(const dataset kind, const std::size_t n) {
+    static std::map<std::pair<dataset, std::size_t>, std::unique_ptr<data>> cache;
+    auto& entry = cache[{kind, n}];
+    if (!entry) {
+        entry = std::make_unique<data>();
+        entry->keys = make_keys(kind, n);
+        const std::size_t q = std::min(n, max_queries);
+        entry->longest_match_queries = make_longest_match_queries(kind, entry->keys, q);
+        entry->prefix_queries = make_prefix_queries(entry->keys, std::min<std::size_t>(q, 10'000));
+        entry->skewed_queries = make_skewed_queries(entry->longest_match_queries, q);
+        entry->miss_queries = make_miss_queries(entry->keys, q);
+    }
+    return *entry;
+}
+
+template <class Adapter>
+std::unique_ptr<Adapter> build(const std::vector<std::string>& keys) {
+    auto adapter = std::make_unique<Adapter>();
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        adapter->insert(keys[i], static_cast<int>(i));
+    }
+    adapter->done();
+    return adapter;
+}
+
+template <class Adapter>
+void bm_insert(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto adapter = build<Adapter>(d.keys);
+        state.PauseTiming();
+        adapter.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.keys.size()));
+}
+
+// build_parallel() of the whole set, with the number of workers as the second argument
+void bm_build_parallel(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    std::vector<std::pair<std::string, int>> values;
+    for (std::size_t i = 0; i < d.keys.size(); i++) {
+        values.emplace_back(d.keys[i], static_cast<int>(i));
+    }
+    for (auto _ : state) {
+        auto tree = std::make_unique<radix_tree<std::string, int>>();
+        tree->build_parallel(values.begin(), values.end(), static_cast<unsigned>(state.range(1)));
+        state.PauseTiming();
+        tree.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.keys.size()));
+}
+
+// parallel_reduce() summing all the values, with the number of workers as the second argument
+void bm_reduce_parallel(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    const auto adapter = build<radix_tree_adapter>(d.keys);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(adapter->c.parallel_reduce(
+            std::string(), 0L, [](const auto& val) { return long(val.second); }, std::plus<long>(),
+            static_cast<unsigned>(state.range(1))));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.keys.size()));
+}
+
+// apply_batch() of a batch erasing every other key and assigning the rest, with the number of workers
+// as the second argument
+void bm_apply_batch(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    std::vector<radix_mutation<std::string, int>> batch;
+    for (std::size_t i = 0; i < d.keys.size(); i++) {
+        batch.push_back({i % 2 == 0 ? radix_mutation_op::erase : radix_mutation_op::assign, d.keys[i], 1});
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto adapter = build<radix_tree_adapter>(d.keys);
+        state.ResumeTiming();
+        adapter->c.apply_batch(batch, static_cast<unsigned>(state.range(1)));
+        state.PauseTiming();
+        adapter.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.size()));
+}
+
+template <class Adapter>
+void bm_find(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    const auto adapter = build<Adapter>(d.keys);
+    const std::size_t q = std::min(d.keys.size(), max_queries);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < q; i++) {
+            benchmark::DoNotOptimize(adapter->find(d.keys[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(q));
+}
+
+template <class Adapter>
+void bm_find_miss(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    const auto adapter = build<Adapter>(d.keys);
+    for (auto _ : state) {
+        for (const auto& query : d.miss_queries) {
+            benchmark::DoNotOptimize(adapter->find(query));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.miss_queries.size()));
+}
+
+// find() on a tree that went through churn: the keys were inserted in random order along with as many
+// temporary ones, erased afterwards. A second argument of 1 compacts the tree before the queries.
+void bm_find_churned(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    radix_tree<std::string, int> tree;
+    for (std::size_t i = 0; i < d.keys.size(); i++) {
+        tree[d.keys[i]] = static_cast<int>(i);
+        tree[d.keys[d.keys.size() - 1 - i] + "~"] = 0;
+    }
+    for (const auto& key : d.keys) {
+        tree.erase(key + "~");
+    }
+    if (state.range(1) != 0) {
+        tree.compact();
+    }
+
+    // queried in another random order than inserted, not to favour the allocation order
+    std::vector<std::string> queries(d.keys.begin(), d.keys.begin() + std::min(d.keys.size(), max_queries));
+    std::ranges::shuffle(queries, std::mt19937_64(queries.size()));
+    for (auto _ : state) {
+        for (const auto& query : queries) {
+            benchmark::DoNotOptimize(tree.find(query));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.size()));
+}
+
+void bm_fuzzy_match(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    radix_tree<std::string, int> tree;
+    for (std::size_t i = 0; i < d.keys.size(); i++) {
+        tree[d.keys[i]] = static_cast<int>(i);
+    }
+
+    // keys with a typo: one element replaced
+    std::vector<std::string> queries(d.keys.begin(), d.keys.begin() + std::min<std::size_t>(d.keys.size(), 1000));
+    for (std::string& query : queries) {
+        if (!query.empty()) {
+            query[query.size() / 2] = 'x';
+        }
+    }
+
+    const int max_distance = static_cast<int>(state.range(1));
+    std::size_t found = 0;
+    for (auto _ : state) {
+        for (const auto& query : queries) {
+            found += tree.fuzzy_match(query, max_distance, [](auto&, int) {});
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.size()));
+    state.counters["found/query"] =
+        static_cast<double>(found) / static_cast<double>(state.iterations() * queries.size());
+}
+
+// the urls on mail hosts one directory deep, by walking the tree (0) or by testing every key (1)
+void bm_match_pattern(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    radix_tree<std::string, int> tree;
+    for (std::size_t i = 0; i < d.keys.size(); i++) {
+        tree[d.keys[i]] = static_cast<int>(i);
+    }
+    const radix_dfa dfa = radix_dfa::glob("https://mail.*/*", '/');
+
+    std::size_t found = 0;
+    for (auto _ : state) {
+        if (state.range(1) == 0) {
+            found = tree.match_pattern(dfa, [](auto&) {});
+        } else {
+            found = 0;
+            for (const auto& [key, value] : tree) {
+                found += dfa.matches(key) ? 1 : 0;
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.counters["found"] = static_cast<double>(found);
+}
+
+// the ten best keys under short prefixes, by top_k() (0) or by sorting the output of prefix_match() (1)
+void bm_top_k(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    typedef radix_tree<std::string, int> tree_type;
+    tree_type tree;
+    tree.enable_score_index([](const tree_type::value_type& val) { return static_cast<double>(val.second); });
+    std::mt19937_64 rng(d.keys.size());
+    for (const auto& key : d.keys) {
+        tree[key] = static_cast<int>(rng() % 1000000);
+        tree.rescore(tree.find(key));
+    }
+
+    std::vector<std::string> prefixes;
+    for (std::size_t i = 0; i < std::min<std::size_t>(d.keys.size(), 100); i++) {
+        prefixes.push_back(d.keys[i * (d.keys.size() / 100)].substr(0, kind == dataset::urls ? 10 : 2));
+    }
+
+    std::vector<tree_type::iterator> vec;
+    const auto better = [](const tree_type::iterator& a, const tree_type::iterator& b) {
+        return a->second > b->second;
+    };
+    for (auto _ : state) {
+        for (const auto& prefix : prefixes) {
+            if (state.range(1) == 0) {
+                tree.top_k(prefix, 10, vec);
+            } else {
+                tree.prefix_match(prefix, vec);
+                const auto middle = vec.begin() + static_cast<std::ptrdiff_t>(std::min<std::size_t>(vec.size(), 10));
+                std::partial_sort(vec.begin(), middle, vec.end(), better);
+            }
+            benchmark::DoNotOptimize(vec.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(prefixes.size()));
+}
+
+// every occurrence of the words in 64 KiB of text, by a matcher compiled from the tree (0) or by a
+// longest_match() at every offset (1), which only finds the longest word starting there
+void bm_scan(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    radix_tree<std::string, int> tree;
+    std::size_t longest = 0;
+    for (std::size_t i = 0; i < d.keys.size(); i++) {
+        tree[d.keys[i]] = static_cast<int>(i);
+        longest = std::max(longest, d.keys[i].size());
+    }
+    const auto matcher = tree.build_matcher();
+
+    std::mt19937_64 rng(d.keys.size());
+    std::string text;
+    while (text.size() < 65536) {
+        text += d.keys[rng() % d.keys.size()];
+        text += ' ';
+    }
+
+    std::size_t found = 0;
+    for (auto _ : state) {
+        found = 0;
+        if (state.range(1) == 0) {
+            found = matcher.scan(text, [](std::uint64_t, auto&) {});
+        } else {
+            for (std::size_t i = 0; i < text.size(); i++) {
+                found += tree.longest_match(text.substr(i, longest)) != tree.end() ? 1 : 0;
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+    state.counters["found"] = static_cast<double>(found);
+}
+
+// 64 KiB of words and spaces split into the longest words, by tokenize() (0) or by a longest_match()
+// of a substring at every token (1)
+void bm_tokenize(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    radix_tree<std::string, int> tree;
+    std::size_t longest = 0;
+    for (std::size_t i = 0; i < d.keys.size(); i++) {
+        tree[d.keys[i]] = static_cast<int>(i);
+        longest = std::max(longest, d.keys[i].size());
+    }
+
+    std::mt19937_64 rng(d.keys.size());
+    std::string text;
+    while (text.size() < 65536) {
+        text += d.keys[rng() % d.keys.size()];
+        text += ' ';
+    }
+
+    std::size_t tokens = 0;
+    for (auto _ : state) {
+        tokens = 0;
+        if (state.range(1) == 0) {
+            tokens = tree.tokenize(text, [](std::string_view, auto*) {});
+        } else {
+            for (std::size_t i = 0; i < text.size(); tokens++) {
+                const auto it = tree.longest_match(text.substr(i, longest));
+                i += it != tree.end() ? it->first.size() : 1;
+            }
+        }
+        benchmark::DoNotOptimize(tokens);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+    state.counters["tokens"] = static_cast<double>(tokens);
+}
+
+// the words containing a few short substrings, by a suffix index (0) or by searching every word (1),
+// with the memory of the index
+void bm_suffix_index(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    radix_suffix_index index;
+    index.add(d.keys.begin(), d.keys.end());
+
+    std::vector<std::string> patterns;
+    for (std::size_t i = 0; i < 100; i++) {
+        const std::string& key = d.keys[i * (d.keys.size() / 100)];
+        patterns.push_back(key.substr(key.size() / 2, 3));
+    }
+
+    std::vector<radix_suffix_index::string_id> ids;
+    std::size_t found = 0;
+    for (auto _ : state) {
+        found = 0;
+        for (const auto& pattern : patterns) {
+            if (state.range(1) == 0) {
+                index.strings_containing(pattern, ids);
+                found += ids.size();
+            } else {
+                for (const auto& key : d.keys) {
+                    found += key.find(pattern) != std::string::npos ? 1 : 0;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(patterns.size()));
+
+    const radix_suffix_stats st = index.stats();
+    state.counters["found/query"] = static_cast<double>(found) / static_cast<double>(patterns.size());
+    state.counters["suffixes"] = static_cast<double>(st.suffixes);
+    state.counters["bytes/suffix"] = static_cast<double>(st.heap_bytes) / static_cast<double>(st.suffixes);
+}
+
+// keys to ids and back, by a radix_dictionary (0) or by a hash map and a vector of the keys (1), with
+// the memory of each
+void bm_dictionary(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    std::vector<std::string> sorted = d.keys;
+    std::ranges::sort(sorted);
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    const std::size_t before = g_heap_bytes.load();
+    radix_dictionary<std::string> dict;
+    std::unordered_map<std::string, std::uint32_t> ids;
+    std::vector<std::string> keys;
+    if (state.range(1) == 0) {
+        dict = radix_dictionary<std::string>(sorted.begin(), sorted.end());
+    } else {
+        keys = sorted;
+        for (std::uint32_t id = 0; id < keys.size(); id++) {
+            ids.emplace(keys[id], id);
+        }
+    }
+    const std::size_t bytes = g_heap_bytes.load() - before;
+
+    std::size_t sum = 0;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < 1000; i++) {
+            const std::string& key = d.keys[(i * 7919) % d.keys.size()];
+            if (state.range(1) == 0) {
+                const std::uint32_t id = *dict.find(key);
+                sum += dict.key(id).size();
+            } else {
+                const std::uint32_t id = ids.find(key)->second;
+                sum += keys[id].size();
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 1000);
+    state.counters["bytes/key"] = static_cast<double>(bytes) / static_cast<double>(sorted.size());
+}
+
+// a keyword table of HTTP header names, fixed at compile time
+constexpr auto header_names = make_radix_static_tree<int>({{"accept", 0},
+                                                           {"accept-encoding", 1},
+                                                           {"accept-language", 2},
+                                                           {"authorization", 3},
+                                                           {"cache-control", 4},
+                                                           {"connection", 5},
+                                                           {"content-encoding", 6},
+                                                           {"content-length", 7},
+                                                           {"content-type", 8},
+                                                           {"cookie", 9},
+                                                           {"date", 10},
+                                                           {"etag", 11},
+                                                           {"expect", 12},
+                                                           {"host", 13},
+                                                           {"if-match", 14},
+                                                           {"if-modified-since", 15},
+                                                           {"if-none-match", 16},
+                                                           {"location", 17},
+                                                           {"origin", 18},
+                                                           {"range", 19},
+                                                           {"referer", 20},
+                                                           {"server", 21},
+                                                           {"set-cookie", 22},
+                                                           {"transfer-encoding", 23},
+                                                           {"upgrade", 24},
+                                                           {"user-agent", 25},
+                                                           {"vary", 26}});
+
+void bm_static_tree(benchmark::State& state) {
+    // the header names of a request stream, with names that are not in the table
+    std::vector<std::string> stream;
+    for (const auto& [name, id] : header_names) {
+        stream.emplace_back(name);
+        stream.push_back(std::string(name) + "-x");
+    }
+    stream.emplace_back("x-request-id");
+    stream.emplace_back("content");
+
+    radix_tree<std::string, int> tree;
+    std::unordered_map<std::string_view, int> map;
+    for (const auto& [name, id] : header_names) {
+        tree[std::string(name)] = id;
+        map.emplace(name, id);
+    }
+
+    int sum = 0;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < 1000; i++) {
+            const std::string& name = stream[(i * 7919) % stream.size()];
+            if (state.range(0) == 0) {
+                const auto it = header_names.find(name);
+                sum += it != header_names.end() ? it->second : -1;
+            } else if (state.range(0) == 1) {
+                const auto it = tree.find(name);
+                sum += it != tree.end() ? it->second : -1;
+            } else {
+                const auto it = map.find(name);
+                sum += it != map.end() ? it->second : -1;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+template <class Adapter>
+void bm_erase(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto adapter = build<Adapter>(d.keys);
+        state.ResumeTiming();
+        for (const auto& key : d.keys) {
+            benchmark::DoNotOptimize(adapter->erase(key));
+        }
+        state.PauseTiming();
+        adapter.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.keys.size()));
+}
+
+template <class Adapter>
+void bm_longest_match(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    const auto adapter = build<Adapter>(d.keys);
+    for (auto _ : state) {
+        for (const auto& query : d.longest_match_queries) {
+            benchmark::DoNotOptimize(adapter->longest_match(query));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.longest_match_queries.size()));
+}
+
+template <class Adapter>
+void bm_longest_match_skewed(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    const auto adapter = build<Adapter>(d.keys);
+    for (auto _ : state) {
+        for (const auto& query : d.skewed_queries) {
+            benchmark::DoNotOptimize(adapter->longest_match(query));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.skewed_queries.size()));
+}
+
+template <class Adapter>
+void bm_prefix_match(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    const auto adapter = build<Adapter>(d.keys);
+    std::size_t found = 0;
+    for (auto _ : state) {
+        for (const auto& query : d.prefix_queries) {
+            found += adapter->prefix_match(query);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.prefix_queries.size()));
+    state.counters["found_per_query"] =
+        static_cast<double>(found) / static_cast<double>(state.iterations() * d.prefix_queries.size());
+}
+
+template <class Adapter>
+void bm_iterate(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    const auto adapter = build<Adapter>(d.keys);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(adapter->iterate());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.keys.size()));
+}
+
+template <class Adapter>
+void bm_memory(benchmark::State& state, const dataset kind) {
+    const data& d = get_data(kind, static_cast<std::size_t>(state.range(0)));
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        const std::size_t before = g_heap_bytes.load();
+        const auto adapter = build<Adapter>(d.keys);
+        bytes = g_heap_bytes.load() - before;
+        if constexpr (requires { adapter->estimated_bytes(); }) {
+            state.counters["estimated_bytes_per_key"] =
+                static_cast<double>(adapter->estimated_bytes()) / static_cast<double>(d.keys.size());
+        }
+    }
+    state.counters["bytes_per_key"] = static_cast<double>(bytes) / static_cast<double>(d.keys.size());
+}
+
+std::vector<int64_t> sizes() {
+    int64_t max_keys = 10'000'000;
+    if (const char* env = std::getenv("RADIX_BENCH_MAX_KEYS")) {
+        max_keys = std::atoll(env);
+    }
+    std::vector<int64_t> result;
+    for (int64_t n = 10'000; n <= max_keys; n *= 10) {
+        result.push_back(n);
+    }
+    return result;
+}
+
+template <class Adapter>
+void register_adapter() {
+    const dataset kinds[] = {dataset::urls, dataset::hostnames, dataset::uuids, dataset::words,
+                             dataset::ipv4_prefixes};
+
+    for (const dataset kind : kinds) {
+        const std::string suffix = std::string("/") + Adapter::name + "/" + dataset_name(kind);
+        std::vector<benchmark::internal::Benchmark*> registered;
+
+        registered.push_back(benchmark::RegisterBenchmark(("insert" + suffix).c_str(), bm_insert<Adapter>, kind));
+        registered.push_back(benchmark::RegisterBenchmark(("find" + suffix).c_str(), bm_find<Adapter>, kind));
+        registered.push_back(
+            benchmark::RegisterBenchmark(("find_miss" + suffix).c_str(), bm_find_miss<Adapter>, kind));
+        if constexpr (requires(Adapter a) { a.erase(std::string()); }) {
+            registered.push_back(benchmark::RegisterBenchmark(("erase" + suffix).c_str(), bm_erase<Adapter>, kind));
+        }
+        registered.push_back(
+            benchmark::RegisterBenchmark(("longest_match" + suffix).c_str(), bm_longest_match<Adapter>, kind));
+        registered.push_back(benchmark::RegisterBenchmark(("longest_match_skewed" + suffix).c_str(),
+                                                          bm_longest_match_skewed<Adapter>, kind));
+        if constexpr (requires(Adapter a) { a.prefix_match(std::string()); }) {
+            registered.push_back(
+                benchmark::RegisterBenchmark(("prefix_match" + suffix).c_str(), bm_prefix_match<Adapter>, kind));
+        }
+        registered.push_back(benchmark::RegisterBenchmark(("iterate" + suffix).c_str(), bm_iterate<Adapter>, kind));
+        registered.push_back(
+            benchmark::RegisterBenchmark(("memory" + suffix).c_str(), bm_memory<Adapter>, kind)->Iterations(1));
+
+        for (auto* b : registered) {
+            for (const int64_t n : sizes()) {
+                b->Arg(n);
+            }
+            b->Unit(benchmark::kMillisecond);
+        }
+    }
+}
+
+void register_parallel() {
+    for (const dataset kind : {dataset::urls, dataset::words}) {
+        const std::string suffix = std::string("/radix_tree/") + dataset_name(kind);
+        for (auto* b : {benchmark::RegisterBenchmark(("build_parallel" + suffix).c_str(), bm_build_parallel, kind),
+                        benchmark::RegisterBenchmark(("reduce_parallel" + suffix).c_str(), bm_reduce_parallel, kind),
+                        benchmark::RegisterBenchmark(("apply_batch" + suffix).c_str(), bm_apply_batch, kind)}) {
+            for (const int64_t n : sizes()) {
+                for (const int64_t threads : {1, 2, 4, 8, 16, 32}) {
+                    b->Args({n, threads});
+                }
+            }
+            b->Unit(benchmark::kMillisecond)->UseRealTime();
+        }
+    }
+}
+
+void register_compact() {
+    for (const dataset kind : {dataset::urls, dataset::words}) {
+        const std::string name = std::string("find_churned/radix_tree/") + dataset_name(kind);
+        auto* b = benchmark::RegisterBenchmark(name.c_str(), bm_find_churned, kind);
+        for (const int64_t n : sizes()) {
+            b->Args({n, 0});
+            b->Args({n, 1});
+        }
+    }
+}
+
+void register_fuzzy() {
+    for (const dataset kind : {dataset::urls, dataset::words}) {
+        const std::string name = std::string("fuzzy_match/radix_tree/") + dataset_name(kind);
+        auto* b = benchmark::RegisterBenchmark(name.c_str(), bm_fuzzy_match, kind);
+        for (const int64_t n : sizes()) {
+            b->Args({n, 1});
+            b->Args({n, 2});
+        }
+    }
+}
+
+void register_pattern() {
+    auto* b = benchmark::RegisterBenchmark("match_pattern/radix_tree/urls", bm_match_pattern, dataset::urls);
+    for (const int64_t n : sizes()) {
+        b->Args({n, 0});
+        b->Args({n, 1});
+    }
+    b->Unit(benchmark::kMicrosecond);
+}
+
+void register_top_k() {
+    for (const dataset kind : {dataset::urls, dataset::words}) {
+        const std::string name = std::string("top_k/radix_tree/") + dataset_name(kind);
+        auto* b = benchmark::RegisterBenchmark(name.c_str(), bm_top_k, kind);
+        for (const int64_t n : sizes()) {
+            b->Args({n, 0});
+            b->Args({n, 1});
+        }
+    }
+}
+
+void register_scan() {
+    auto* b = benchmark::RegisterBenchmark("scan/radix_matcher/words", bm_scan, dataset::words);
+    for (const int64_t n : sizes()) {
+        b->Args({n, 0});
+        b->Args({n, 1});
+    }
+    b->Unit(benchmark::kMicrosecond);
+}
+
+void register_tokenize() {
+    auto* b = benchmark::RegisterBenchmark("tokenize/radix_tree/words", bm_tokenize, dataset::words);
+    for (const int64_t n : sizes()) {
+        b->Args({n, 0});
+        b->Args({n, 1});
+    }
+    b->Unit(benchmark::kMicrosecond);
+}
+
+void register_suffix_index() {
+    auto* b = benchmark::RegisterBenchmark("suffix_index/radix_tree/words", bm_suffix_index, dataset::words);
+    // every word costs a node per suffix, so the largest sizes do not fit
+    for (const int64_t n : sizes()) {
+        if (n <= 100'000) {
+            b->Args({n, 0});
+            b->Args({n, 1});
+        }
+    }
+    b->Unit(benchmark::kMicrosecond);
+}
+
+void register_dictionary() {
+    for (const dataset kind : {dataset::urls, dataset::words}) {
+        const std::string name = std::string("dictionary/radix_dictionary/") + dataset_name(kind);
+        auto* b = benchmark::RegisterBenchmark(name.c_str(), bm_dictionary, kind);
+        for (const int64_t n : sizes()) {
+            b->Args({n, 0});
+            b->Args({n, 1});
+        }
+    }
+}
+
+void register_static_tree() {
+    // 0: radix_static_tree, 1: radix_tree, 2: std::unordered_map
+    auto* b = benchmark::RegisterBenchmark("static_tree/header_names", bm_static_tree);
+    for (const int64_t variant : {0, 1, 2}) {
+        b->Arg(variant);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    register_adapter<radix_tree_adapter>();
+    register_adapter<radix_tree_hash_index_adapter>();
+    register_adapter<radix_tree_bloom_adapter>();
+    register_adapter<radix_tree_cached_adapter>();
+    register_adapter<radix_burst_tree_adapter>();
+    register_adapter<std_map_adapter>();
+    register_adapter<std_unordered_map_adapter>();
+    register_adapter<sorted_vector_adapter>();
+    register_parallel();
+    register_compact();
+    register_fuzzy();
+    register_pattern();
+    register_top_k();
+    register_scan();
+    register_tokenize();
+    register_suffix_index();
+    register_dictionary();
+    register_static_tree();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
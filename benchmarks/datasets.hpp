@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// generated, reproducible key sets with the shapes seen in practice
+
+enum class dataset { urls, hostnames, uuids, words, ipv4_prefixes };
+
+inline const char* dataset_name(const dataset kind) {
+    switch (kind) {
+    case dataset::urls: return "urls";
+    case dataset::hostnames: return "hostnames";
+    case dataset::uuids: return "uuids";
+    case dataset::words: return "words";
+    case dataset::ipv4_prefixes: return "ipv4_prefixes";
+    }
+    return "";
+}
+
+namespace datasets_detail {
+
+inline std::string word(std::mt19937_64& rng, const int min_syllables, const int max_syllables) {
+    static const char* const onsets[] = {"b", "c", "d", "f", "g", "h", "k", "l", "m", "n", "p", "r", "s",
+                                         "t", "v", "w", "br", "ch", "cl", "dr", "gr", "pl", "st", "th", "tr"};
+    static const char* const vowels[] = {"a", "e", "i", "o", "u", "ai", "ea", "ou", "io"};
+    static const char* const codas[] = {"", "", "", "n", "r", "s", "t", "l", "nd", "ng", "st"};
+
+    std::uniform_int_distribution<int> syllables(min_syllables, max_syllables);
+    std::string result;
+    for (int i = syllables(rng); i > 0; i--) {
+        result += onsets[rng() % std::size(onsets)];
+        result += vowels[rng() % std::size(vowels)];
+        result += codas[rng() % std::size(codas)];
+    }
+    return result;
+}
+
+// a skewed pick, so that a few values are much more frequent than the others
+inline std::size_t zipf_like(std::mt19937_64& rng, const std::size_t n) {
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    const double x = dist(rng);
+    return std::min(n - 1, static_cast<std::size_t>(static_cast<double>(n) * x * x * x));
+}
+
+inline std::vector<std::string> pool(std::mt19937_64& rng, const std::size_t n, const int min_syllables,
+                                     const int max_syllables) {
+    std::vector<std::string> result;
+    for (std::size_t i = 0; i < n; i++) {
+        result.push_back(word(rng, min_syllables, max_syllables));
+    }
+    return result;
+}
+
+inline std::string hostname(std::mt19937_64& rng, const std::vector<std::string>& names) {
+    static const char* const tlds[] = {".com", ".net", ".org", ".io", ".de", ".co.uk", ".jp"};
+    static const char* const subdomains[] = {"", "", "www.", "api.", "cdn.", "mail.", "static."};
+    return std::string(subdomains[rng() % std::size(subdomains)]) + names[rng() % names.size()] +
+           tlds[zipf_like(rng, std::size(tlds))];
+}
+
+inline std::string uuid(std::mt19937_64& rng) {
+    static const char hex[] = "0123456789abcdef";
+    std::string result(36, '-');
+    for (std::size_t i = 0; i < result.size(); i++) {
+        if (i != 8 && i != 13 && i != 18 && i != 23) {
+            result[i] = hex[rng() % 16];
+        }
+    }
+    return result;
+}
+
+// the network bits of a prefix, one character per bit, as the bit-wise keys of examples/example2.cpp
+inline std::string ipv4_prefix(std::mt19937_64& rng) {
+    static const int lengths[] = {8, 12, 16, 16, 20, 22, 24, 24, 24, 24, 28, 32};
+    const int len = lengths[rng() % std::size(lengths)];
+    const auto addr = static_cast<std::uint32_t>(rng());
+    std::string result(len, '0');
+    for (int i = 0; i < len; i++) {
+        if (addr & (0x80000000u >> i)) {
+            result[i] = '1';
+        }
+    }
+    return result;
+}
+
+} // namespace datasets_detail
+
+// `n` distinct keys in random order
+inline std::vector<std::string> make_keys(const dataset kind, const std::size_t n) {
+    using namespace datasets_detail;
+
+    std::mt19937_64 rng(static_cast<std::uint64_t>(kind) * 7919 + n);
+    const std::vector<std::string> names = pool(rng, std::max<std::size_t>(n / 4, 16), 1, 4);
+    const std::vector<std::string> paths = pool(rng, 512, 1, 3);
+
+    std::vector<std::string> keys;
+    keys.reserve(n + n / 4);
+    std::size_t serial = 0;
+    while (keys.size() < n) {
+        for (std::size_t i = keys.size(); i < n + n / 8; i++) {
+            switch (kind) {
+            case dataset::urls: {
+                std::string url = "https://" + hostname(rng, names);
+                for (std::size_t depth = rng() % 4; depth > 0; depth--) {
+                    url += '/';
+                    url += paths[zipf_like(rng, paths.size())];
+                }
+                if (rng() % 3 == 0) {
+                    url += "?id=" + std::to_string(serial++);
+                }
+                keys.push_back(url);
+                break;
+            }
+            case dataset::hostnames: keys.push_back(hostname(rng, names)); break;
+            case dataset::uuids: keys.push_back(uuid(rng)); break;
+            case dataset::words: keys.push_back(word(rng, 1, 5)); break;
+            case dataset::ipv4_prefixes: keys.push_back(ipv4_prefix(rng)); break;
+            }
+        }
+        std::ranges::sort(keys);
+        const auto dup = std::ranges::unique(keys);
+        keys.erase(dup.begin(), dup.end());
+    }
+    std::ranges::shuffle(keys, rng);
+    keys.resize(n);
+    return keys;
+}
+
+// queries for longest_match: stored keys with some garbage appended, as a lookup of a full path or address
+inline std::vector<std::string> make_longest_match_queries(const dataset kind, const std::vector<std::string>& keys,
+                                                           const std::size_t n) {
+    std::mt19937_64 rng(static_cast<std::uint64_t>(kind) * 104729 + n);
+    std::vector<std::string> queries;
+    queries.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        std::string query = keys[rng() % keys.size()];
+        if (kind == dataset::ipv4_prefixes) {
+            while (query.size() < 32) {
+                query += (rng() & 1) ? '1' : '0';
+            }
+        } else {
+            query += '/';
+            query += datasets_detail::word(rng, 1, 2);
+        }
+        queries.push_back(query);
+    }
+    return queries;
+}
+
+// prefixes of stored keys, for prefix_match
+inline std::vector<std::string> make_prefix_queries(const std::vector<std::string>& keys, const std::size_t n) {
+    std::mt19937_64 rng(n);
+    std::vector<std::string> queries;
+    queries.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        const std::string& key = keys[rng() % keys.size()];
+        // long enough to select a small part of the set
+        queries.push_back(key.substr(0, std::min(key.size(), 4 + key.size() * 3 / 4)));
+    }
+    return queries;
+}
+
+// find queries of which only one in twenty is stored; the others extend a stored key by one element
+inline std::vector<std::string> make_miss_queries(const std::vector<std::string>& keys, const std::size_t n) {
+    std::mt19937_64 rng(n * 17);
+    std::vector<std::string> queries;
+    queries.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        std::string query = keys[rng() % keys.size()];
+        if (rng() % 20 != 0) {
+            query += '~';
+        }
+        queries.push_back(query);
+    }
+    return queries;
+}
+
+// a stream drawn from `queries` with a heavily skewed popularity
+inline std::vector<std::string> make_skewed_queries(const std::vector<std::string>& queries, const std::size_t n) {
+    std::mt19937_64 rng(n * 31);
+    const std::size_t distinct = std::min<std::size_t>(queries.size(), 4096);
+    std::vector<std::string> result;
+    result.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        result.push_back(queries[datasets_detail::zipf_like(rng, distinct)]);
+    }
+    return result;
+}
@@ -1,53 +1,57 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <exception>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "radix_tree_automaton.hpp"
+#include "radix_tree_bloom.hpp"
+#include "radix_tree_hash_index.hpp"
 #include "radix_tree_it.hpp"
+#include "radix_tree_key.hpp"
+#include "radix_tree_matcher.hpp"
 #include "radix_tree_node.hpp"
+#include "radix_tree_parallel.hpp"
+#include "radix_tree_pool.hpp"
+#include "radix_tree_rank.hpp"
+#include "radix_tree_score.hpp"
+#include "radix_tree_set_it.hpp"
+#include "radix_tree_stats.hpp"
+
+// what radix_tree::tokenize() does with a byte where no key begins
+enum class radix_unmatched {
+    emit, // reports it as a one-byte token without a value
+    skip, // drops it
+    stop, // ends the tokenization before it
+};
 
-template <typename K>
-K radix_substr(const K& key, int begin, int num);
-
-template <>
-inline std::string radix_substr<std::string>(const std::string& key, const int begin, const int num) {
-    return key.substr(begin, num);
-}
-
-template <typename K>
-K radix_join(const K& key1, const K& key2);
-
-template <>
-inline std::string radix_join<std::string>(const std::string& key1, const std::string& key2) {
-    return key1 + key2;
-}
-
-template <typename K>
-int radix_length(const K& key);
-
-template <>
-inline int radix_length<std::string>(const std::string& key) {
-    return static_cast<int>(key.size());
-}
-
-template <typename K, typename T, typename Compare>
+template <typename K, typename T, typename Compare, typename Instrument>
 class radix_tree {
   public:
     typedef K key_type;
     typedef T mapped_type;
     typedef std::pair<const K, T> value_type;
     typedef radix_tree_it<K, T, Compare> iterator;
+    typedef radix_tree_set_it<K, T, Compare> set_iterator;
     typedef std::size_t size_type;
+    typedef Instrument instrumentation_type;
 
     radix_tree() = default;
 
     explicit radix_tree(Compare pred) : m_predicate(pred) {}
 
-    ~radix_tree() = default;
+    ~radix_tree() { clear(); }
 
     [[nodiscard]]
     size_type size() const {
@@ -60,10 +64,110 @@ class radix_tree {
     }
 
     void clear() {
-        m_root.reset();
+        if (m_root) {
+            delete_subtree(m_root);
+            m_root = nullptr;
+        }
+        if (m_compacting) {
+            m_compact_from.release();
+            m_compacting = false;
+        }
+        // nodes handed over to another tree by attach() keep the chunks alive
+        if (m_pool.live() == 0) {
+            m_pool.release();
+        }
         m_size = 0;
+        m_generation++;
+        if (m_index) {
+            m_index->clear();
+        }
+        if (m_bloom) {
+            m_bloom->clear();
+        }
+        if (m_scores) {
+            m_scores->clear();
+        }
+        if (m_ranks) {
+            m_ranks->clear();
+        }
     }
 
+    // changes whenever an element is inserted or erased, so results of earlier lookups can be validated
+    [[nodiscard]]
+    std::uint64_t generation() const {
+        return m_generation;
+    }
+
+    // Keeps a hash table from every key to its leaf, so that find(), operator[] and erase() cost one
+    // hash probe instead of a descent. Everything else still walks the tree.
+    void enable_hash_index()
+        requires radix_hashable<K>;
+
+    void disable_hash_index() { m_index.reset(); }
+
+    [[nodiscard]]
+    bool has_hash_index() const {
+        return m_index != nullptr;
+    }
+
+    // Keeps a Bloom filter over the keys, so that find() and erase() reject most absent keys after
+    // reading one cache line. Erased keys stay in the filter until it is rebuilt, which happens when
+    // they outnumber the remaining ones or when the tree outgrows the filter.
+    void enable_bloom_filter(double fp_rate = 0.01)
+        requires radix_hashable<K>;
+
+    void disable_bloom_filter() { m_bloom.reset(); }
+
+    [[nodiscard]]
+    bool has_bloom_filter() const {
+        return m_bloom != nullptr;
+    }
+
+    // Keeps the highest score(value) below every internal node, so that top_k() finds the best elements
+    // under a prefix without visiting the others. insert() and erase() keep the maxima up to date, a
+    // value changed through a reference has to be reported with rescore(). The parallel operations
+    // recompute all maxima once they are done.
+    void enable_score_index(std::function<double(const value_type&)> score);
+
+    void disable_score_index() { m_scores.reset(); }
+
+    [[nodiscard]]
+    bool has_score_index() const {
+        return m_scores != nullptr;
+    }
+
+    // updates the maxima above `it` after its value was changed in place; nothing without a score index
+    void rescore(iterator it);
+
+    // Keeps the number of elements below every internal node, so that rank() and select() translate
+    // between keys and their positions in key order in one descent: dense ordinal ids that keep the
+    // order of the keys. Maintained like the score index.
+    void enable_rank_index();
+
+    void disable_rank_index() { m_ranks.reset(); }
+
+    [[nodiscard]]
+    bool has_rank_index() const {
+        return m_ranks != nullptr;
+    }
+
+    // the number of elements whose keys are less than `key`, which is the position of `key` in key
+    // order if it is in the tree. Needs the rank index, and returns 0 without it. Labels are compared element
+    // by element, as a lexicographic Compare does, see radix_lexicographic.
+    size_type rank(const K& key);
+
+    // the element at position `pos` in key order, end() if there is none or the rank index is disabled.
+    iterator select(size_type pos);
+
+    // the effectiveness of the Bloom filter since it was enabled
+    [[nodiscard]]
+    const radix_bloom_stats& bloom_stats() const {
+        return m_bloom_stats;
+    }
+
+    // the counters of the instrumentation policy
+    Instrument& instrumentation() { return m_instrument; }
+
     iterator find(const K& key);
 
     iterator begin();
@@ -72,6 +176,26 @@ class radix_tree {
 
     std::pair<iterator, bool> insert(const value_type& val);
 
+    // inserts val, searching from `hint` instead of the root: only the part of the key after its common
+    // prefix with hint->first is compared. hint must be end() or refer to an element of this tree.
+    iterator insert(iterator hint, const value_type& val);
+
+    // inserts a range of values, each hinted with the previously inserted element, so a sorted range
+    // costs only the part of each key that differs from its predecessor.
+    template <class InputIt>
+    void insert(InputIt first, InputIt last);
+
+    // inserts a range of values using `threads` workers, 0 for one per hardware thread. The input is
+    // split by leading key elements into groups that own disjoint subtrees; every group is built on
+    // its own and then grafted into the tree. Duplicates keep the first value, as with insert().
+    template <class ForwardIt>
+    void build_parallel(ForwardIt first, ForwardIt last, unsigned threads = 0);
+
+    // Applies a batch of inserts, assignments and erasures using `threads` workers, 0 for one per
+    // hardware thread, with the same result as applying them one by one in order. The batch is sorted
+    // by key and split into groups that own disjoint subtrees, which are changed concurrently.
+    void apply_batch(std::span<const radix_mutation<K, T>> mutations, unsigned threads = 0);
+
     bool erase(const K& key);
 
     void erase(iterator it);
@@ -80,10 +204,99 @@ class radix_tree {
 
     void greedy_match(const K& key, std::vector<iterator>& vec);
 
+    // Fills vec with the up to k elements with the highest scores among those whose keys begin with
+    // `prefix`, best first. Needs the score index, and finds nothing without it: the search is best-first
+    // over the cached maxima, so it costs about k times the depth of the tree, whatever the number of keys
+    // under the prefix.
+    void top_k(const K& prefix, std::size_t k, std::vector<iterator>& vec);
+
     iterator longest_match(const K& key);
 
+    // Calls visitor(value_type&) for every element whose key is a prefix of `key`, the empty key and
+    // `key` itself included, shortest first, stopping early when the visitor returns false. All of
+    // them lie on the path of `key`, so this is a single descent. Returns the elements visited.
+    template <class Visitor>
+    std::size_t for_each_prefix_of(const K& key, Visitor visitor);
+
+    // fills vec with the elements whose keys are prefixes of `key`, shortest first
+    void prefixes_of(const K& key, std::vector<iterator>& vec);
+
     T& operator[](const K& lhs);
 
+    // Calls visitor(value_type&, int distance) in key order for every element whose key is within
+    // `max_distance` insertions, deletions and substitutions of `key`, stopping early when the visitor
+    // returns false or after `limit` elements. Every edge extends a row of the edit distance table, and
+    // subtrees whose row exceeds `max_distance` everywhere are skipped. Returns the elements visited.
+    template <class Visitor>
+    std::size_t fuzzy_match(const K& key, int max_distance, Visitor visitor,
+                            std::size_t limit = std::numeric_limits<std::size_t>::max());
+
+    // Calls visitor(value_type&) in key order for every element whose key `automaton` accepts, such as
+    // a radix_dfa compiled from a glob or a regular expression, stopping early when the visitor returns
+    // false or after `limit` elements. The automaton is stepped along the edge labels and subtrees are
+    // skipped once it is in a dead state. An automaton with a literal_prefix() is started at the node of
+    // that prefix. Returns the elements visited.
+    template <class Automaton, class Visitor>
+    std::size_t match_pattern(const Automaton& automaton, Visitor visitor,
+                              std::size_t limit = std::numeric_limits<std::size_t>::max());
+
+    // Compiles the keys into an Aho-Corasick matcher that finds all their occurrences in a text in one
+    // pass, instead of a longest_match() at every offset. The keys must have byte-sized elements. The
+    // matcher refers to the values of the tree and is invalidated by any change of the tree.
+    radix_matcher<K, T, Compare> build_matcher();
+
+    // Splits `text` into tokens, each the longest key at its position, and calls
+    // visitor(std::string_view token, value_type* value) for each in order. Bytes where no key begins
+    // are handled as `unmatched` says, with a null value. The tree is walked along the text itself,
+    // without copying it into keys, and the empty key is never a token. Stops early when the visitor
+    // returns false. Returns the tokens reported. The keys must have byte-sized elements.
+    template <class Visitor>
+    std::size_t tokenize(std::string_view text, Visitor visitor, radix_unmatched unmatched = radix_unmatched::emit);
+
+    // Calls visitor(value_type&) for every element from up to `threads` workers, 0 for one per hardware
+    // thread. The tree is cut into subtrees, each visited in key order by one worker, so the visitor
+    // must be safe to call concurrently. The tree must not be modified meanwhile.
+    template <class Visitor>
+    void parallel_for_each(Visitor visitor, unsigned threads = 0);
+
+    // Folds map(const value_type&) with combine over the elements whose keys begin with `prefix`. The
+    // subtrees are folded concurrently and their results combined in key order, so combine must be
+    // associative but need not be commutative. Returns combine(init, fold), or init if nothing matches.
+    template <class R, class Map, class Combine>
+    R parallel_reduce(const K& prefix, R init, Map map, Combine combine, unsigned threads = 0);
+
+    // node counts, histograms and estimated memory use, gathered in one traversal
+    radix_tree_stats stats() const;
+
+    // Moves all nodes, edge labels, child map entries and values to fresh memory in depth-first order,
+    // so that a descent or a walk along the keys touches neighbouring memory again after churn. The
+    // contents are unchanged, but all iterators and references into the tree are invalidated.
+    void compact() { compact_step(std::numeric_limits<std::size_t>::max()); }
+
+    // Does the work of compact() for at most `budget` nodes, starting a compaction if none is under
+    // way, and returns true once it is complete. The tree may be used and modified between the steps.
+    // Every step invalidates all iterators and references into the tree.
+    bool compact_step(std::size_t budget);
+
+    // lazy set algebra against another tree, walking both trees edge by edge
+    radix_set_view<K, T, Compare> set_intersection(radix_tree& other) {
+        return set_operation(radix_set_op::intersection, other);
+    }
+
+    radix_set_view<K, T, Compare> set_difference(radix_tree& other) {
+        return set_operation(radix_set_op::difference, other);
+    }
+
+    radix_set_view<K, T, Compare> set_symmetric_difference(radix_tree& other) {
+        return set_operation(radix_set_op::symmetric_difference, other);
+    }
+
+    radix_set_view<K, T, Compare> set_union(radix_tree& other) { return set_operation(radix_set_op::union_, other); }
+
+    radix_set_view<K, T, Compare> set_operation(radix_set_op op, radix_tree& other) {
+        return radix_set_view<K, T, Compare>{set_iterator(op, m_predicate, root(), other.root())};
+    }
+
     template <class UnaryPred>
     void remove_if(UnaryPred pred) {
         iterator backIt;
@@ -96,37 +309,367 @@ class radix_tree {
         }
     }
 
+    // A position in the tree that lookups start from. Like the hinted insert(), seek() and insert()
+    // climb from the previous position only up to its common prefix with the new key, so a nearly
+    // sorted stream of keys costs only the differing suffix of each. An insert or erase done through
+    // anything else than this cursor sends its next operation back to the root.
+    class cursor {
+      public:
+        explicit cursor(radix_tree& tree) : m_tree(&tree) {}
+
+        // same as find()
+        iterator seek(const K& key);
+
+        // same as insert()
+        std::pair<iterator, bool> insert(const value_type& val);
+
+      private:
+        radix_tree* m_tree;
+        // the deepest visited node whose key is a prefix of m_key
+        radix_tree_node<K, T, Compare>* m_node{};
+        K m_key{};
+        std::uint64_t m_generation{};
+
+        radix_tree_node<K, T, Compare>* start(const K& key);
+
+        void settle(radix_tree_node<K, T, Compare>* reached, const K& key);
+    };
+
+    // tokenize() of a text that arrives in buffers. A token that may still grow with the next buffer is
+    // held back until it is certain, so tokens can span buffers; such a token is passed to the visitor
+    // from a copy that lives until the visitor returns. The tree must not change during the stream.
+    class tokenizer {
+      public:
+        explicit tokenizer(radix_tree& tree, const radix_unmatched unmatched = radix_unmatched::emit)
+            : m_tree(&tree), m_unmatched(unmatched) {}
+
+        // tokenizes the next buffer, returns the tokens reported
+        template <class Visitor>
+        std::size_t feed(std::string_view chunk, Visitor visitor);
+
+        // tokenizes what was held back at the end of the stream
+        template <class Visitor>
+        std::size_t finish(Visitor visitor);
+
+        // whether the visitor or an unmatched byte ended the stream; later buffers are ignored
+        [[nodiscard]]
+        bool stopped() const {
+            return m_stopped;
+        }
+
+      private:
+        radix_tree* m_tree;
+        radix_unmatched m_unmatched;
+        // the bytes from the start of the undecided token on
+        std::string m_pending;
+        bool m_stopped{};
+    };
+
     radix_tree(const radix_tree& other) = delete;
 
     radix_tree& operator=(radix_tree other) = delete;
 
   private:
+    typedef radix_key_traits<K> key_traits;
+    static_assert(radix_key_traits_for<key_traits, K>, "radix_key_traits<K> does not describe K");
+
     size_type m_size{};
-    std::unique_ptr<radix_tree_node<K, T, Compare>> m_root{};
-    radix_tree_node<K, T, Compare>* root() { return m_root.get(); }
+    std::uint64_t m_generation{};
+    radix_node_pool<radix_tree_node<K, T, Compare>> m_pool;
+    radix_tree_node<K, T, Compare>* m_root{};
+    radix_tree_node<K, T, Compare>* root() { return m_root; }
+
+    // the pool a compaction under way moves the nodes out of
+    radix_node_pool<radix_tree_node<K, T, Compare>> m_compact_from;
+    bool m_compacting{};
+    // the next node to move, as long as the generation is unchanged
+    radix_tree_node<K, T, Compare>* m_compact_next{};
+    std::uint64_t m_compact_generation{};
+    // the key of the last node moved: the nodes still to be moved all come after it in key order
+    K m_compact_path{};
 
     Compare m_predicate{};
 
+    [[no_unique_address]]
+    Instrument m_instrument{};
+
+    std::unique_ptr<radix_hash_index<K, T, Compare>> m_index{};
+
+    std::unique_ptr<radix_bloom_filter<K>> m_bloom{};
+    radix_bloom_stats m_bloom_stats{};
+
+    std::unique_ptr<radix_score_index<K, T, Compare>> m_scores{};
+
+    // recomputes the maxima from `node` up, as long as they change
+    void refresh_scores(radix_tree_node<K, T, Compare>* node) {
+        for (; node != nullptr && m_scores->update(node); node = node->m_parent) {
+        }
+    }
+
+    void rebuild_score_index(radix_tree_node<K, T, Compare>* node);
+
+    std::unique_ptr<radix_rank_index<K, T, Compare>> m_ranks{};
+
+    // recomputes the counts from `node` up
+    void refresh_ranks(radix_tree_node<K, T, Compare>* node) {
+        for (; node != nullptr && m_ranks->update(node); node = node->m_parent) {
+        }
+    }
+
+    void rebuild_rank_index(radix_tree_node<K, T, Compare>* node);
+
+    void rebuild_bloom_filter();
+
+    // false if the Bloom filter rules out `key`
+    bool bloom_admits(const K& key) {
+        // erase() cannot rebuild the filter halfway through restructuring the tree, so it is done here
+        if (m_bloom->stale() > m_size) {
+            rebuild_bloom_filter();
+        }
+
+        m_bloom_stats.queries++;
+        if (m_bloom->may_contain(key)) {
+            return true;
+        }
+        m_bloom_stats.rejected++;
+        return false;
+    }
+
+    // an owned slice of `key`, for an edge label
+    K substr(const K& key, const int begin, const int num) {
+        m_instrument.count(radix_event::substr);
+        return key_traits::to_key(key_traits::slice(key_traits::view(key), begin, num));
+    }
+
+    static int key_length(const K& key) { return key_traits::length(key_traits::view(key)); }
+
+    // whether `key` continues with `label` at offset `depth`
+    static bool continues_with(const K& key, const int depth, const K& label) {
+        const auto& view = key_traits::view(key);
+        const int len = key_length(label);
+        return depth + len <= key_traits::length(view) &&
+               key_traits::common_prefix(key_traits::slice(view, depth, len), key_traits::view(label)) == len;
+    }
+
+    // the label of `node` preceded by the label of its parent, sliced from a key below `node`
+    K joined_label(radix_tree_node<K, T, Compare>* parent, radix_tree_node<K, T, Compare>* node) {
+        radix_tree_node<K, T, Compare>* leaf = node;
+        while (!leaf->m_is_leaf) {
+            leaf = leaf->m_children.begin()->second;
+        }
+        return substr(leaf->m_value->first, parent->m_depth, key_length(parent->m_key) + key_length(node->m_key));
+    }
+
+    radix_tree_node<K, T, Compare>* new_node() {
+        m_instrument.count(radix_event::node_alloc);
+        return m_pool.create(m_predicate);
+    }
+
+    radix_tree_node<K, T, Compare>* new_node(const value_type& val) {
+        m_instrument.count(radix_event::node_alloc);
+        return m_pool.create(val, m_predicate);
+    }
+
+    void delete_node(radix_tree_node<K, T, Compare>* node) {
+        m_instrument.count(radix_event::node_free);
+        if (m_scores && !node->m_is_leaf) {
+            m_scores->erase(node);
+        }
+        if (m_ranks && !node->m_is_leaf) {
+            m_ranks->erase(node);
+        }
+        if (m_compacting && m_compact_from.owns(node)) {
+            m_compact_from.destroy(node);
+        } else {
+            m_pool.destroy(node);
+        }
+    }
+
+    void delete_subtree(radix_tree_node<K, T, Compare>* node) {
+        for (auto& child : node->m_children) {
+            delete_subtree(child.second);
+        }
+        delete_node(node);
+    }
+
     radix_tree_node<K, T, Compare>* begin(radix_tree_node<K, T, Compare>* node);
 
     radix_tree_node<K, T, Compare>* find_node(const K& key, radix_tree_node<K, T, Compare>* node, int depth);
 
+    // find_node() starting from the deepest ancestor of `start` whose key is a prefix of `key`.
+    // the key of `start` must itself be a prefix of `start_key`.
+    radix_tree_node<K, T, Compare>* find_node_from(const K& key, radix_tree_node<K, T, Compare>* start,
+                                                   const K& start_key);
+
+    int common_prefix(const K& key1, const K& key2) const;
+
+    void ensure_root(const K& key);
+
+    std::pair<iterator, bool> insert_at(radix_tree_node<K, T, Compare>* node, const value_type& val);
+
+    template <class Item>
+    struct prefix_group {
+        int depth;
+        std::vector<Item> items;
+    };
+
+    // Splits `items` by the key element after the prefix of each group until no group is larger than
+    // `max_size`. No group prefix is then a prefix of another one, so the groups own disjoint subtrees.
+    // Items whose keys end where their group is split go to `serial`, in their original order.
+    template <class Item, class KeyOf>
+    static void group_by_prefix(std::vector<Item> items, KeyOf key_of, std::size_t max_size,
+                                std::vector<prefix_group<Item>>& groups, std::vector<Item>& serial);
+
+    // groups for `count` items, enough to balance `workers` workers
+    static std::size_t max_group_size(const std::size_t count, const unsigned workers) {
+        constexpr std::size_t min_group_size = 256;
+        return std::max(count / (8 * workers), min_group_size);
+    }
+
+    // a copy of `node` in fresh memory, which takes its place in the tree. `node` is added to `retired`
+    // to be deleted by the caller.
+    radix_tree_node<K, T, Compare>* relocate(radix_tree_node<K, T, Compare>* node,
+                                             std::vector<radix_tree_node<K, T, Compare>*>& retired);
+
+    // the internal node after `node` in depth-first order, or after its whole subtree
+    radix_tree_node<K, T, Compare>* next_internal(radix_tree_node<K, T, Compare>* node);
+    radix_tree_node<K, T, Compare>* subtree_successor(radix_tree_node<K, T, Compare>* node);
+
+    // the key from the root to the end of the edge label of `node`
+    K path_of(radix_tree_node<K, T, Compare>* node);
+
+    // the first internal node whose path comes after m_compact_path
+    radix_tree_node<K, T, Compare>* compact_resume();
+
+    // moves whatever the tree holds under `prefix` into the empty tree `part`, rooted at that prefix,
+    // and returns the node to attach() it back to
+    radix_tree_node<K, T, Compare>* detach(const K& prefix, radix_tree& part);
+
+    // moves the content of `part` back under `point`, see detach(). the size is left to the caller, and so is
+    // the normalize() of `point`, which waits until every part is back.
+    void attach(radix_tree_node<K, T, Compare>* point, radix_tree& part);
+
+    // the node whose key is `prefix`, made by adding a node or splitting an edge if there is none.
+    // such a node may be left with a single child, which normalize() fixes once it is filled.
+    radix_tree_node<K, T, Compare>* graft_point(const K& prefix);
+
+    // restores path compression at `node`, by merging it with its only child
+    void normalize(radix_tree_node<K, T, Compare>* node);
+
+    // bookkeeping for a newly inserted leaf
+    std::pair<iterator, bool> track_insert(radix_tree_node<K, T, Compare>* leaf) {
+        m_generation++;
+        if constexpr (radix_hashable<K>) {
+            if (m_index) {
+                m_index->insert(leaf);
+            }
+            if (m_bloom) {
+                m_bloom->insert(leaf->m_value->first);
+                if (m_bloom->inserted() > m_bloom->capacity()) {
+                    rebuild_bloom_filter();
+                }
+            }
+        }
+        if (m_scores) {
+            refresh_scores(leaf->m_parent);
+        }
+        if (m_ranks) {
+            refresh_ranks(leaf->m_parent);
+        }
+        return std::pair<iterator, bool>(iterator{leaf}, true);
+    }
+
     radix_tree_node<K, T, Compare>* append(radix_tree_node<K, T, Compare>* parent, const value_type& val);
 
     radix_tree_node<K, T, Compare>* prepend(radix_tree_node<K, T, Compare>* node, const value_type& val);
 
+    // removes a leaf found by find_node() and merges the nodes it leaves with a single child. returns the
+    // lowest remaining node whose subtree lost the leaf.
+    radix_tree_node<K, T, Compare>* erase_leaf(radix_tree_node<K, T, Compare>* child);
+
     void greedy_match(radix_tree_node<K, T, Compare>* node, std::vector<iterator>& vec);
+
+    // the node whose subtree holds exactly the keys that begin with `key`, nullptr if there are none
+    radix_tree_node<K, T, Compare>* prefix_node(const K& key);
+
+    // the subtree of `top` cut into at least `count` subtrees where possible, in key order
+    std::vector<radix_tree_node<K, T, Compare>*> split_subtree(radix_tree_node<K, T, Compare>* top, std::size_t count);
+
+    template <class F>
+    void for_each_leaf(radix_tree_node<K, T, Compare>* node, F& f);
+
+    // the state of fuzzy_match(): `rows` holds one row of the edit distance table for every key element
+    // on the path to the current node, `remaining` the number of elements still to be visited
+    template <class Visitor>
+    struct fuzzy_search {
+        typename key_traits::view_type key;
+        int max_distance;
+        Visitor& visitor;
+        std::size_t remaining;
+        std::vector<int> rows;
+    };
+
+    // returns false once the search is over
+    template <class Visitor>
+    bool fuzzy_walk(radix_tree_node<K, T, Compare>* node, fuzzy_search<Visitor>& search);
+
+    // the leaf of `node` and its child whose label begins with the first element of `rest`, either of which
+    // may be null. The child is found by a lookup of that element alone in the child map when Compare
+    // orders labels element by element, and by a scan of the children otherwise.
+    std::pair<radix_tree_node<K, T, Compare>*, radix_tree_node<K, T, Compare>*>
+    leaf_and_child(radix_tree_node<K, T, Compare>* node, const typename key_traits::view_type& rest);
+
+    // calls f(leaf) for the leaf of every prefix of `key`, shortest first, until f returns false.
+    // Returns the leaves passed to f.
+    template <class F>
+    std::size_t prefix_leaves(const K& key, F f);
+
+    // the longest non-empty key at the beginning of `text`, with a null value if there is none.
+    // `complete` is false when the text ended while a longer key could still follow.
+    struct munch_result {
+        std::size_t length;
+        value_type* value;
+        bool complete;
+    };
+
+    munch_result munch(std::string_view text);
+
+    // tokenizes `text` up to a token that the next buffer could still change, unless `final`, and returns
+    // the bytes consumed. `stopped` is set when the visitor or an unmatched byte ended the tokenization.
+    template <class Visitor>
+    std::size_t tokenize_run(std::string_view text, bool final, radix_unmatched unmatched, Visitor& visitor,
+                             std::size_t& count, bool& stopped);
+
+    template <class Automaton, class Visitor>
+    bool pattern_walk(radix_tree_node<K, T, Compare>* node, const Automaton& automaton,
+                      typename Automaton::state_type state, Visitor& visitor, std::size_t& remaining);
+
+    // calls the visitor of a search, which may return false to end it
+    template <class Visitor, class... Args>
+    static bool call_visitor(Visitor& visitor, Args&&... args) {
+        if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, Args...>>) {
+            visitor(std::forward<Args>(args)...);
+            return true;
+        } else {
+            return static_cast<bool>(visitor(std::forward<Args>(args)...));
+        }
+    }
 };
 
-template <typename K, typename T, typename Compare>
-void radix_tree<K, T, Compare>::prefix_match(const K& key, std::vector<iterator>& vec) {
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::prefix_match(const K& key, std::vector<iterator>& vec) {
     vec.clear();
 
-    if (!m_root) {
-        return;
+    if (radix_tree_node<K, T, Compare>* node = prefix_node(key)) {
+        greedy_match(node, vec);
     }
+}
 
-    K key_sub1, key_sub2;
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare, Instrument>::prefix_node(const K& key) {
+    if (!m_root) {
+        return nullptr;
+    }
 
     radix_tree_node<K, T, Compare>* node = find_node(key, root(), 0);
 
@@ -134,24 +677,394 @@ void radix_tree<K, T, Compare>::prefix_match(const K& key, std::vector<iterator>
         node = node->m_parent;
     }
 
-    int len = radix_length(key) - node->m_depth;
-    key_sub1 = radix_substr(key, node->m_depth, len);
-    key_sub2 = radix_substr(node->m_key, 0, len);
+    // the rest of the key has to be a prefix of the edge label
+    const auto& view = key_traits::view(key);
+    const int len = key_traits::length(view) - node->m_depth;
+
+    if (key_traits::common_prefix(key_traits::slice(view, node->m_depth, len), key_traits::view(node->m_key)) < len) {
+        return nullptr;
+    }
+
+    return node;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+std::vector<radix_tree_node<K, T, Compare>*>
+radix_tree<K, T, Compare, Instrument>::split_subtree(radix_tree_node<K, T, Compare>* top, const std::size_t count) {
+    // expand the whole frontier one level at a time, which keeps it in key order
+    std::vector<radix_tree_node<K, T, Compare>*> frontier{top};
+    std::vector<radix_tree_node<K, T, Compare>*> next;
+
+    while (frontier.size() < count) {
+        next.clear();
+        for (radix_tree_node<K, T, Compare>* node : frontier) {
+            if (node->m_is_leaf) {
+                next.push_back(node);
+                continue;
+            }
+            for (auto& child : node->m_children) {
+                next.push_back(child.second);
+            }
+        }
+        if (next.size() == frontier.size()) {
+            break;
+        }
+        frontier.swap(next);
+    }
+
+    return frontier;
+}
 
-    if (key_sub1 != key_sub2) {
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class F>
+void radix_tree<K, T, Compare, Instrument>::for_each_leaf(radix_tree_node<K, T, Compare>* node, F& f) {
+    if (node->m_is_leaf) {
+        f(*node->m_value);
         return;
     }
 
-    greedy_match(node, vec);
+    for (auto& child : node->m_children) {
+        for_each_leaf(child.second, f);
+    }
 }
 
-template <typename K, typename T, typename Compare>
-typename radix_tree<K, T, Compare>::iterator radix_tree<K, T, Compare>::longest_match(const K& key) {
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class Visitor>
+void radix_tree<K, T, Compare, Instrument>::parallel_for_each(Visitor visitor, const unsigned threads) {
     if (!m_root) {
-        return iterator(nullptr);
+        return;
+    }
+
+    const unsigned workers = radix_worker_count(threads);
+    const std::vector<radix_tree_node<K, T, Compare>*> tasks = split_subtree(root(), 8 * workers);
+
+    radix_work_stealing_for(tasks.size(), workers, [&](const std::size_t i) { for_each_leaf(tasks[i], visitor); });
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class R, class Map, class Combine>
+R radix_tree<K, T, Compare, Instrument>::parallel_reduce(const K& prefix, R init, Map map, Combine combine,
+                                                         const unsigned threads) {
+    radix_tree_node<K, T, Compare>* top = prefix_node(prefix);
+    if (top == nullptr) {
+        return init;
+    }
+
+    const unsigned workers = radix_worker_count(threads);
+    const std::vector<radix_tree_node<K, T, Compare>*> tasks = split_subtree(top, 8 * workers);
+    std::vector<std::optional<R>> results(tasks.size());
+
+    radix_work_stealing_for(tasks.size(), workers, [&](const std::size_t i) {
+        std::optional<R>& acc = results[i];
+        auto fold = [&](const value_type& val) {
+            if (acc) {
+                acc = combine(std::move(*acc), map(val));
+            } else {
+                acc.emplace(map(val));
+            }
+        };
+        for_each_leaf(tasks[i], fold);
+    });
+
+    for (std::optional<R>& result : results) {
+        if (result) {
+            init = combine(std::move(init), std::move(*result));
+        }
+    }
+    return init;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class Visitor>
+std::size_t radix_tree<K, T, Compare, Instrument>::fuzzy_match(const K& key, const int max_distance, Visitor visitor,
+                                                              const std::size_t limit) {
+    if (!m_root || max_distance < 0 || limit == 0) {
+        return 0;
+    }
+
+    // d + 1 must not overflow
+    const int d = std::min(max_distance, std::numeric_limits<int>::max() - 1);
+    fuzzy_search<Visitor> search{key_traits::view(key), d, visitor, limit, {}};
+    // the row of the empty path: the distance to each prefix of the key is its length
+    const int width = key_traits::length(search.key) + 1;
+    search.rows.reserve(static_cast<std::size_t>(width) * 16);
+    for (int j = 0; j < width; j++) {
+        search.rows.push_back(std::min(j, d + 1));
+    }
+
+    fuzzy_walk(root(), search);
+    return limit - search.remaining;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class Visitor>
+bool radix_tree<K, T, Compare, Instrument>::fuzzy_walk(radix_tree_node<K, T, Compare>* node,
+                                                       fuzzy_search<Visitor>& search) {
+    m_instrument.count(radix_event::node_visit);
+
+    std::vector<int>& rows = search.rows;
+    const int d = search.max_distance;
+    const int n = key_traits::length(search.key);
+    const std::size_t width = static_cast<std::size_t>(n) + 1;
+    const std::size_t mark = rows.size();
+
+    // One row per element of the edge label. Only the cells within `d` of the diagonal can be within
+    // the bound, the others are left at d + 1.
+    const auto& label = key_traits::view(node->m_key);
+    const int len = key_traits::length(label);
+    for (int i = 0; i < len; i++) {
+        const auto e = key_traits::at(label, i);
+        const int depth = static_cast<int>(rows.size() / width);
+        rows.resize(rows.size() + width, d + 1);
+        int* row = rows.data() + rows.size() - width;
+        const int* prev = row - width;
+
+        row[0] = std::min(prev[0] + 1, d + 1);
+        int lowest = row[0];
+        const int hi = d >= n - depth ? n : depth + d;
+        for (int j = std::max(1, depth - d); j <= hi; j++) {
+            const int substitute = prev[j - 1] + (key_traits::at(search.key, j - 1) == e ? 0 : 1);
+            row[j] = std::min({prev[j] + 1, row[j - 1] + 1, substitute, d + 1});
+            lowest = std::min(lowest, row[j]);
+        }
+        // the distance only grows along the path
+        if (lowest > d) {
+            rows.resize(mark);
+            return true;
+        }
+    }
+
+    bool go_on = true;
+    for (auto& child : node->m_children) {
+        radix_tree_node<K, T, Compare>* next = child.second;
+        if (!next->m_is_leaf) {
+            go_on = fuzzy_walk(next, search);
+        } else if (const int distance = rows.back(); distance <= search.max_distance) {
+            go_on = call_visitor(search.visitor, *next->m_value, distance);
+            go_on = --search.remaining > 0 && go_on;
+        }
+        if (!go_on) {
+            break;
+        }
+    }
+
+    rows.resize(mark);
+    return go_on;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class Automaton, class Visitor>
+std::size_t radix_tree<K, T, Compare, Instrument>::match_pattern(const Automaton& automaton, Visitor visitor,
+                                                                const std::size_t limit) {
+    typedef std::remove_cvref_t<decltype(key_traits::at(std::declval<typename key_traits::view_type>(), 0))> element;
+    static_assert(radix_automaton<Automaton, element>, "match_pattern() needs an automaton over the key elements");
+
+    if (!m_root || limit == 0) {
+        return 0;
+    }
+
+    radix_tree_node<K, T, Compare>* top = root();
+    typename Automaton::state_type state = automaton.start();
+
+    if constexpr (requires { automaton.literal_prefix(); }) {
+        const auto literal = automaton.literal_prefix();
+        if constexpr (std::is_constructible_v<K, decltype(literal)>) {
+            // every match lies below the node of the prefix, the automaton only has to be run from there
+            const K prefix(literal);
+            top = prefix_node(prefix);
+            if (top == nullptr) {
+                return 0;
+            }
+            const auto& view = key_traits::view(prefix);
+            for (int i = 0; i < top->m_depth; i++) {
+                state = automaton.step(state, key_traits::at(view, i));
+            }
+        }
+    }
+
+    std::size_t remaining = limit;
+    pattern_walk(top, automaton, state, visitor, remaining);
+    return limit - remaining;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+typename radix_tree<K, T, Compare, Instrument>::munch_result
+radix_tree<K, T, Compare, Instrument>::munch(const std::string_view text) {
+    typedef std::remove_cvref_t<decltype(key_traits::at(std::declval<typename key_traits::view_type>(), 0))> element;
+    static_assert(sizeof(element) == 1, "tokenize() needs keys of bytes");
+
+    munch_result best{0, nullptr, true};
+    if (!m_root) {
+        return best;
+    }
+
+    radix_tree_node<K, T, Compare>* node = root();
+    std::size_t i = 0;
+    for (;;) {
+        // the text viewed as a key, of which only the first element is looked at
+        const typename key_traits::view_type rest(reinterpret_cast<const element*>(text.data() + i),
+                                                  i < text.size() ? 1 : 0);
+        const auto [leaf, next] = leaf_and_child(node, rest);
+        if (leaf != nullptr && i > 0) {
+            best = munch_result{i, leaf->m_value, true};
+        }
+        if (i == text.size()) {
+            // whether no longer key can follow
+            best.complete = node->m_children.size() == (leaf != nullptr ? 1 : 0);
+            return best;
+        }
+        if (next == nullptr) {
+            return best;
+        }
+
+        const auto& label = key_traits::view(next->m_key);
+        const auto len = static_cast<std::size_t>(key_traits::length(label));
+        for (std::size_t j = 1; j < len; j++) {
+            if (i + j == text.size()) {
+                best.complete = false;
+                return best;
+            }
+            if (static_cast<unsigned char>(key_traits::at(label, static_cast<int>(j))) !=
+                static_cast<unsigned char>(text[i + j])) {
+                return best;
+            }
+        }
+        node = next;
+        i += len;
     }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class Visitor>
+std::size_t radix_tree<K, T, Compare, Instrument>::tokenize_run(const std::string_view text, const bool final,
+                                                               const radix_unmatched unmatched, Visitor& visitor,
+                                                               std::size_t& count, bool& stopped) {
+    std::size_t i = 0;
+    while (i < text.size()) {
+        const munch_result token = munch(text.substr(i));
+        if (!token.complete && !final) {
+            break;
+        }
+
+        if (token.value == nullptr && unmatched == radix_unmatched::stop) {
+            stopped = true;
+            break;
+        }
+        const std::size_t len = token.value != nullptr ? token.length : 1;
+        if (token.value != nullptr || unmatched == radix_unmatched::emit) {
+            count++;
+            if (!call_visitor(visitor, text.substr(i, len), token.value)) {
+                stopped = true;
+                return i + len;
+            }
+        }
+        i += len;
+    }
+    return i;
+}
 
-    K key_sub;
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class Visitor>
+std::size_t radix_tree<K, T, Compare, Instrument>::tokenize(const std::string_view text, Visitor visitor,
+                                                           const radix_unmatched unmatched) {
+    std::size_t count = 0;
+    bool stopped = false;
+    tokenize_run(text, true, unmatched, visitor, count, stopped);
+    return count;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class Visitor>
+std::size_t radix_tree<K, T, Compare, Instrument>::tokenizer::feed(const std::string_view chunk, Visitor visitor) {
+    std::size_t count = 0;
+    std::size_t pos = 0;
+
+    // the held back bytes are completed one byte of the chunk at a time, until the tokens that begin
+    // in them are certain; a token is never longer than the longest key
+    for (std::size_t taken = 0; !m_stopped && !m_pending.empty();) {
+        const std::size_t consumed =
+            m_tree->tokenize_run(m_pending, false, m_unmatched, visitor, count, m_stopped);
+        m_pending.erase(0, consumed);
+        if (m_pending.size() <= taken) {
+            pos = taken - m_pending.size();
+            m_pending.clear();
+            break;
+        }
+        if (taken == chunk.size()) {
+            return count;
+        }
+        m_pending.push_back(chunk[taken++]);
+    }
+    if (m_stopped) {
+        m_pending.clear();
+        return count;
+    }
+
+    const std::string_view rest = chunk.substr(pos);
+    const std::size_t consumed = m_tree->tokenize_run(rest, false, m_unmatched, visitor, count, m_stopped);
+    if (!m_stopped) {
+        m_pending.assign(rest.substr(consumed));
+    }
+    return count;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class Visitor>
+std::size_t radix_tree<K, T, Compare, Instrument>::tokenizer::finish(Visitor visitor) {
+    std::size_t count = 0;
+    if (!m_stopped) {
+        m_tree->tokenize_run(m_pending, true, m_unmatched, visitor, count, m_stopped);
+    }
+    m_pending.clear();
+    return count;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_matcher<K, T, Compare> radix_tree<K, T, Compare, Instrument>::build_matcher() {
+    typedef std::remove_cvref_t<decltype(key_traits::at(std::declval<typename key_traits::view_type>(), 0))> element;
+    static_assert(sizeof(element) == 1, "build_matcher() needs keys of bytes");
+
+    return radix_matcher<K, T, Compare>(m_root);
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class Automaton, class Visitor>
+bool radix_tree<K, T, Compare, Instrument>::pattern_walk(radix_tree_node<K, T, Compare>* node,
+                                                         const Automaton& automaton,
+                                                         typename Automaton::state_type state, Visitor& visitor,
+                                                         std::size_t& remaining) {
+    m_instrument.count(radix_event::node_visit);
+
+    const auto& label = key_traits::view(node->m_key);
+    const int len = key_traits::length(label);
+    for (int i = 0; i < len; i++) {
+        state = automaton.step(state, key_traits::at(label, i));
+        if (automaton.dead(state)) {
+            return true;
+        }
+    }
+
+    for (auto& child : node->m_children) {
+        radix_tree_node<K, T, Compare>* next = child.second;
+        if (!next->m_is_leaf) {
+            if (!pattern_walk(next, automaton, state, visitor, remaining)) {
+                return false;
+            }
+        } else if (automaton.accepts(state)) {
+            const bool go_on = call_visitor(visitor, *next->m_value);
+            if (--remaining == 0 || !go_on) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+typename radix_tree<K, T, Compare, Instrument>::iterator radix_tree<K, T, Compare, Instrument>::longest_match(const K& key) {
+    if (!m_root) {
+        return iterator(nullptr);
+    }
 
     radix_tree_node<K, T, Compare>* node = find_node(key, root(), 0);
 
@@ -159,13 +1072,11 @@ typename radix_tree<K, T, Compare>::iterator radix_tree<K, T, Compare>::longest_
         return iterator(node);
     }
 
-    key_sub = radix_substr(key, node->m_depth, radix_length(node->m_key));
-
-    if (!(key_sub == node->m_key)) {
+    if (!continues_with(key, node->m_depth, node->m_key)) {
         node = node->m_parent;
     }
 
-    K nul = radix_substr(key, 0, 0);
+    K nul = substr(key, 0, 0);
 
     while (node != nullptr) {
         typename radix_tree_node<K, T, Compare>::it_child it;
@@ -180,14 +1091,104 @@ typename radix_tree<K, T, Compare>::iterator radix_tree<K, T, Compare>::longest_
     return iterator(nullptr);
 }
 
-template <typename K, typename T, typename Compare>
+template <typename K, typename T, typename Compare, typename Instrument>
+std::pair<radix_tree_node<K, T, Compare>*, radix_tree_node<K, T, Compare>*>
+radix_tree<K, T, Compare, Instrument>::leaf_and_child(radix_tree_node<K, T, Compare>* node,
+                                                      const typename key_traits::view_type& rest) {
+    std::pair<radix_tree_node<K, T, Compare>*, radix_tree_node<K, T, Compare>*> found{nullptr, nullptr};
+
+    auto it = node->m_children.find(key_traits::to_key(key_traits::slice(rest, 0, 0)));
+    if (it != node->m_children.end() && it->second->m_is_leaf) {
+        found.first = it->second;
+    }
+    if (key_traits::length(rest) == 0) {
+        return found;
+    }
+
+    if constexpr (radix_lexicographic<K, Compare>) {
+        // the labels of the children begin with distinct elements, and a label sorts right after its first
+        // element alone
+        it = node->m_children.lower_bound(key_traits::to_key(key_traits::slice(rest, 0, 1)));
+        if (it != node->m_children.end() && !it->second->m_is_leaf &&
+            key_traits::at(key_traits::view(it->first), 0) == key_traits::at(rest, 0)) {
+            found.second = it->second;
+        }
+    } else {
+        for (auto& child : node->m_children) {
+            m_instrument.count(radix_event::child_scan);
+            if (!child.second->m_is_leaf &&
+                key_traits::at(key_traits::view(child.first), 0) == key_traits::at(rest, 0)) {
+                found.second = child.second;
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class F>
+std::size_t radix_tree<K, T, Compare, Instrument>::prefix_leaves(const K& key, F f) {
+    if (!m_root) {
+        return 0;
+    }
+
+    const auto& view = key_traits::view(key);
+    const int len = key_traits::length(view);
+    radix_tree_node<K, T, Compare>* node = root();
+    int depth = 0;
+    std::size_t count = 0;
+
+    for (;;) {
+        m_instrument.count(radix_event::node_visit);
+
+        const auto [leaf, next] = leaf_and_child(node, key_traits::slice(view, depth, len - depth));
+        if (leaf != nullptr) {
+            count++;
+            if (!f(leaf)) {
+                return count;
+            }
+        }
+        if (next == nullptr) {
+            return count;
+        }
+
+        const auto& label = key_traits::view(next->m_key);
+        const int len_node = key_traits::length(label);
+        if (depth + len_node > len ||
+            key_traits::common_prefix(key_traits::slice(view, depth, len_node), label) < len_node) {
+            return count;
+        }
+        node = next;
+        depth += len_node;
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class Visitor>
+std::size_t radix_tree<K, T, Compare, Instrument>::for_each_prefix_of(const K& key, Visitor visitor) {
+    return prefix_leaves(key, [&visitor](radix_tree_node<K, T, Compare>* leaf) {
+        return call_visitor(visitor, *leaf->m_value);
+    });
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::prefixes_of(const K& key, std::vector<iterator>& vec) {
+    vec.clear();
+    prefix_leaves(key, [&vec](radix_tree_node<K, T, Compare>* leaf) {
+        vec.push_back(iterator(leaf));
+        return true;
+    });
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
 // ReSharper disable once CppMemberFunctionMayBeStatic
-typename radix_tree<K, T, Compare>::iterator radix_tree<K, T, Compare>::end() {
+typename radix_tree<K, T, Compare, Instrument>::iterator radix_tree<K, T, Compare, Instrument>::end() {
     return iterator(nullptr);
 }
 
-template <typename K, typename T, typename Compare>
-typename radix_tree<K, T, Compare>::iterator radix_tree<K, T, Compare>::begin() {
+template <typename K, typename T, typename Compare, typename Instrument>
+typename radix_tree<K, T, Compare, Instrument>::iterator radix_tree<K, T, Compare, Instrument>::begin() {
     radix_tree_node<K, T, Compare>* node;
 
     if (!m_root || m_size == 0) {
@@ -199,8 +1200,8 @@ typename radix_tree<K, T, Compare>::iterator radix_tree<K, T, Compare>::begin()
     return iterator(node);
 }
 
-template <typename K, typename T, typename Compare>
-radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare>::begin(radix_tree_node<K, T, Compare>* node) {
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare, Instrument>::begin(radix_tree_node<K, T, Compare>* node) {
     if (node->m_is_leaf) {
         return node;
     }
@@ -208,8 +1209,8 @@ radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare>::begin(radix_tree_node
     return begin(node->m_children.begin()->second);
 }
 
-template <typename K, typename T, typename Compare>
-T& radix_tree<K, T, Compare>::operator[](const K& lhs) {
+template <typename K, typename T, typename Compare, typename Instrument>
+T& radix_tree<K, T, Compare, Instrument>::operator[](const K& lhs) {
     iterator it = find(lhs);
 
     if (it == end()) {
@@ -219,90 +1220,595 @@ T& radix_tree<K, T, Compare>::operator[](const K& lhs) {
         std::pair<iterator, bool> ret;
         ret = insert(val);
 
-        assert(ret.second == true);
+        assert(ret.second == true);
+
+        it = ret.first;
+    }
+
+    return it->second;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::greedy_match(const K& key, std::vector<iterator>& vec) {
+    vec.clear();
+
+    if (!m_root) {
+        return;
+    }
+
+    radix_tree_node<K, T, Compare>* node = find_node(key, root(), 0);
+
+    if (node->m_is_leaf) {
+        node = node->m_parent;
+    }
+
+    greedy_match(node, vec);
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::greedy_match(radix_tree_node<K, T, Compare>* node, std::vector<iterator>& vec) {
+    if (node->m_is_leaf) {
+        vec.push_back(iterator(node));
+        return;
+    }
+
+    typename std::map<K, radix_tree_node<K, T, Compare>*>::iterator it;
+
+    for (it = node->m_children.begin(); it != node->m_children.end(); ++it) {
+        greedy_match(it->second, vec);
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::enable_hash_index()
+    requires radix_hashable<K>
+{
+    if (m_index) {
+        return;
+    }
+
+    m_index.reset(new radix_hash_index<K, T, Compare>());
+    for (iterator it = begin(); it != end(); ++it) {
+        m_index->insert(it.m_pointee);
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::enable_bloom_filter(const double fp_rate)
+    requires radix_hashable<K>
+{
+    m_bloom.reset(new radix_bloom_filter<K>(0, fp_rate));
+    m_bloom_stats = radix_bloom_stats();
+    rebuild_bloom_filter();
+    m_bloom_stats.rebuilds = 0;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::rebuild_bloom_filter() {
+    // twice the current size, so that growing the tree rebuilds the filter a logarithmic number of times
+    constexpr std::size_t min_capacity = 64;
+    m_bloom.reset(new radix_bloom_filter<K>(std::max(2 * m_size, min_capacity), m_bloom->fp_rate()));
+    m_bloom_stats.rebuilds++;
+
+    for (iterator it = begin(); it != end(); ++it) {
+        m_bloom->insert(it->first);
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::enable_score_index(std::function<double(const value_type&)> score) {
+    m_scores.reset(new radix_score_index<K, T, Compare>(std::move(score)));
+    if (m_root) {
+        rebuild_score_index(root());
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::rebuild_score_index(radix_tree_node<K, T, Compare>* node) {
+    for (auto& child : node->m_children) {
+        if (!child.second->m_is_leaf) {
+            rebuild_score_index(child.second);
+        }
+    }
+    m_scores->update(node);
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::rescore(iterator it) {
+    if (m_scores) {
+        refresh_scores(it.m_pointee->m_parent);
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::enable_rank_index() {
+    m_ranks.reset(new radix_rank_index<K, T, Compare>());
+    if (m_root) {
+        rebuild_rank_index(root());
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::rebuild_rank_index(radix_tree_node<K, T, Compare>* node) {
+    for (auto& child : node->m_children) {
+        if (!child.second->m_is_leaf) {
+            rebuild_rank_index(child.second);
+        }
+    }
+    m_ranks->update(node);
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+typename radix_tree<K, T, Compare, Instrument>::size_type radix_tree<K, T, Compare, Instrument>::rank(const K& key) {
+    if (!m_root || !m_ranks) {
+        return 0;
+    }
+
+    const auto& view = key_traits::view(key);
+    const int len = key_traits::length(view);
+    radix_tree_node<K, T, Compare>* node = root();
+    int depth = 0;
+    size_type before = 0;
+
+    // every subtree that is passed on the way down, in key order, holds smaller keys only
+    for (;;) {
+        m_instrument.count(radix_event::node_visit);
+        if (depth == len) {
+            return before;
+        }
+        const auto rest = key_traits::slice(view, depth, len - depth);
+        const auto first = key_traits::at(rest, 0);
+
+        radix_tree_node<K, T, Compare>* next = nullptr;
+        for (auto& child : node->m_children) {
+            if (child.second->m_is_leaf) {
+                // a proper prefix of `key`
+                before++;
+                continue;
+            }
+            const auto& label = key_traits::view(child.first);
+            if (key_traits::at(label, 0) == first) {
+                const int len_node = key_traits::length(label);
+                const int count = key_traits::common_prefix(label, rest);
+                if (count == len_node) {
+                    next = child.second;
+                } else if (count < len - depth &&
+                           radix_element_less(key_traits::at(label, count), key_traits::at(rest, count))) {
+                    before += m_ranks->count(child.second);
+                }
+                break;
+            }
+            if (radix_element_less(first, key_traits::at(label, 0))) {
+                break;
+            }
+            before += m_ranks->count(child.second);
+        }
+
+        if (next == nullptr) {
+            return before;
+        }
+        depth += key_length(next->m_key);
+        node = next;
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+typename radix_tree<K, T, Compare, Instrument>::iterator radix_tree<K, T, Compare, Instrument>::select(size_type pos) {
+    if (!m_root || !m_ranks || pos >= m_size) {
+        return end();
+    }
+
+    radix_tree_node<K, T, Compare>* node = root();
+    for (;;) {
+        m_instrument.count(radix_event::node_visit);
+        for (auto& child : node->m_children) {
+            const size_type count = m_ranks->count(child.second);
+            if (pos >= count) {
+                pos -= count;
+                continue;
+            }
+            if (child.second->m_is_leaf) {
+                return iterator(child.second);
+            }
+            node = child.second;
+            break;
+        }
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::top_k(const K& prefix, const std::size_t k, std::vector<iterator>& vec) {
+    vec.clear();
+    if (!m_scores) {
+        return;
+    }
+
+    radix_tree_node<K, T, Compare>* top = prefix_node(prefix);
+    if (top == nullptr || k == 0) {
+        return;
+    }
+
+    // a max-heap of subtrees by their best score: a leaf on top beats everything still in the heap
+    typedef std::pair<double, radix_tree_node<K, T, Compare>*> entry;
+    const auto lower = [](const entry& a, const entry& b) { return a.first < b.first; };
+    std::vector<entry> heap{{m_scores->max(top), top}};
+
+    while (!heap.empty() && vec.size() < k) {
+        std::ranges::pop_heap(heap, lower);
+        radix_tree_node<K, T, Compare>* node = heap.back().second;
+        heap.pop_back();
+
+        if (node->m_is_leaf) {
+            vec.push_back(iterator(node));
+            continue;
+        }
+
+        m_instrument.count(radix_event::node_visit);
+        for (auto& child : node->m_children) {
+            heap.emplace_back(m_scores->max(child.second), child.second);
+            std::ranges::push_heap(heap, lower);
+        }
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_stats radix_tree<K, T, Compare, Instrument>::stats() const {
+    typedef radix_tree_node<K, T, Compare> node_type;
+
+    radix_tree_stats st;
+    const std::size_t last = radix_tree_stats::histogram_size - 1;
+    // an entry of std::map: the pair plus the color and three links of the red-black tree
+    const std::size_t map_entry_size = sizeof(typename node_type::it_child::value_type) + 4 * sizeof(void*);
+
+    node_type* node = m_root;
+    std::size_t level = 0;
+    // what labels and map keys own beyond the nodes and map entries they are part of
+    std::size_t heap_label_bytes = 0;
+
+    // depth-first walk through the parent links, so it needs no stack
+    while (node != nullptr) {
+        st.node_bytes += sizeof(node_type);
+        st.edge_label_length += static_cast<std::size_t>(key_length(node->m_key));
+        st.edge_label_bytes += sizeof(K) + radix_heap_bytes(node->m_key);
+        heap_label_bytes += radix_heap_bytes(node->m_key);
+
+        if (node->m_value != nullptr) {
+            st.value_bytes += sizeof(value_type) + radix_heap_bytes(node->m_value->first) +
+                              radix_heap_bytes(node->m_value->second);
+        }
+
+        if (node->m_is_leaf) {
+            st.leaf_nodes++;
+            st.depth[std::min(level, last)]++;
+        } else {
+            st.internal_nodes++;
+            st.fanout[std::min(node->m_children.size(), last)]++;
+        }
+
+        for (auto it = node->m_children.begin(); it != node->m_children.end(); ++it) {
+            st.map_entry_bytes += map_entry_size;
+            st.duplicated_key_bytes += sizeof(K) + radix_heap_bytes(it->first);
+            heap_label_bytes += radix_heap_bytes(it->first);
+        }
+
+        if (!node->m_children.empty()) {
+            node = node->m_children.begin()->second;
+            level++;
+            continue;
+        }
+
+        // climb until a node with an unvisited sibling
+        while (node->m_parent != nullptr) {
+            auto it = node->m_parent->m_children.find(node->m_key);
+            ++it;
+            if (it != node->m_parent->m_children.end()) {
+                node = it->second;
+                break;
+            }
+            node = node->m_parent;
+            level--;
+        }
+
+        if (node->m_parent == nullptr) {
+            break;
+        }
+    }
+
+    st.free_node_bytes = m_pool.memory_bytes() + m_compact_from.memory_bytes() - st.node_bytes;
+
+    if (m_index) {
+        st.index_bytes = sizeof(*m_index) + m_index->memory_bytes();
+    }
+
+    if (m_bloom) {
+        st.bloom_bytes = sizeof(*m_bloom) + m_bloom->memory_bytes();
+    }
+
+    if (m_scores) {
+        st.score_index_bytes = sizeof(*m_scores) + m_scores->memory_bytes();
+    }
+
+    if (m_ranks) {
+        st.rank_index_bytes = sizeof(*m_ranks) + m_ranks->memory_bytes();
+    }
+
+    st.heap_bytes = st.node_bytes + st.free_node_bytes + st.map_entry_bytes + st.value_bytes + heap_label_bytes +
+                    st.index_bytes + st.bloom_bytes + st.score_index_bytes + st.rank_index_bytes;
+    return st;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+bool radix_tree<K, T, Compare, Instrument>::compact_step(const std::size_t budget) {
+    if (budget == 0) {
+        return !m_compacting && !m_root;
+    }
+    if (!m_compacting) {
+        if (!m_root) {
+            return true;
+        }
+        // new nodes, moved ones included, come from a fresh pool while the old one empties
+        m_compact_from.swap(m_pool);
+        m_compacting = true;
+        m_compact_next = root();
+        m_compact_generation = m_generation;
+    }
+
+    radix_tree_node<K, T, Compare>* node = m_generation == m_compact_generation ? m_compact_next : compact_resume();
+    radix_tree_node<K, T, Compare>* last = nullptr;
+    std::size_t moved = 0;
+    // the moved nodes are only deleted at the end, so that the copies are not allocated into the holes
+    // they would leave all over the heap
+    std::vector<radix_tree_node<K, T, Compare>*> retired;
+
+    // internal nodes in depth-first order, each followed by its leaf
+    for (; node != nullptr && moved < budget; node = next_internal(node)) {
+        if (m_compact_from.owns(node)) {
+            node = relocate(node, retired);
+            moved++;
+        }
+        for (auto& child : node->m_children) {
+            if (child.second->m_is_leaf) {
+                if (m_compact_from.owns(child.second)) {
+                    relocate(child.second, retired);
+                    moved++;
+                }
+                break;
+            }
+        }
+        last = node;
+    }
+
+    for (radix_tree_node<K, T, Compare>* old : retired) {
+        delete_node(old);
+    }
+    if (moved > 0) {
+        m_generation++;
+    }
 
-        it = ret.first;
+    if (node == nullptr) {
+        assert(m_compact_from.live() == 0);
+        m_compact_from.release();
+        m_compacting = false;
+        m_compact_next = nullptr;
+        return true;
     }
 
-    return it->second;
+    m_compact_next = node;
+    m_compact_generation = m_generation;
+    if (last != nullptr) {
+        m_compact_path = path_of(last);
+    }
+    return false;
 }
 
-template <typename K, typename T, typename Compare>
-void radix_tree<K, T, Compare>::greedy_match(const K& key, std::vector<iterator>& vec) {
-    vec.clear();
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>*
+radix_tree<K, T, Compare, Instrument>::relocate(radix_tree_node<K, T, Compare>* node,
+                                                std::vector<radix_tree_node<K, T, Compare>*>& retired) {
+    radix_tree_node<K, T, Compare>* moved = new_node();
+
+    moved->m_parent = node->m_parent;
+    moved->m_key = node->m_key;
+    moved->m_depth = node->m_depth;
+    moved->m_is_leaf = node->m_is_leaf;
+    if (node->m_value != nullptr) {
+        moved->m_value = new value_type(node->m_value->first, std::move(node->m_value->second));
+    }
 
-    if (!m_root) {
-        return;
+    // entries inserted in order at the end are allocated in order
+    for (auto& child : node->m_children) {
+        moved->m_children.emplace_hint(moved->m_children.end(), child.first, child.second);
+        child.second->m_parent = moved;
     }
 
-    radix_tree_node<K, T, Compare>* node = find_node(key, root(), 0);
+    if (node == root()) {
+        m_root = moved;
+    } else {
+        moved->m_parent->m_children.find(moved->m_key)->second = moved;
+    }
 
-    if (node->m_is_leaf) {
-        node = node->m_parent;
+    if constexpr (radix_hashable<K>) {
+        if (m_index && moved->m_is_leaf) {
+            m_index->replace(node, moved);
+        }
+    }
+    if (m_scores && !moved->m_is_leaf) {
+        m_scores->replace(node, moved);
+    }
+    if (m_ranks && !moved->m_is_leaf) {
+        m_ranks->replace(node, moved);
     }
 
-    greedy_match(node, vec);
+    retired.push_back(node);
+    return moved;
 }
 
-template <typename K, typename T, typename Compare>
-void radix_tree<K, T, Compare>::greedy_match(radix_tree_node<K, T, Compare>* node, std::vector<iterator>& vec) {
-    if (node->m_is_leaf) {
-        vec.push_back(iterator(node));
-        return;
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>*
+radix_tree<K, T, Compare, Instrument>::next_internal(radix_tree_node<K, T, Compare>* node) {
+    for (auto& child : node->m_children) {
+        if (!child.second->m_is_leaf) {
+            return child.second;
+        }
     }
+    return subtree_successor(node);
+}
 
-    typename std::map<K, radix_tree_node<K, T, Compare>*>::iterator it;
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>*
+radix_tree<K, T, Compare, Instrument>::subtree_successor(radix_tree_node<K, T, Compare>* node) {
+    while (node != root()) {
+        radix_tree_node<K, T, Compare>* parent = node->m_parent;
+        auto it = parent->m_children.find(node->m_key);
+        for (++it; it != parent->m_children.end(); ++it) {
+            if (!it->second->m_is_leaf) {
+                return it->second;
+            }
+        }
+        node = parent;
+    }
+    return nullptr;
+}
 
-    for (it = node->m_children.begin(); it != node->m_children.end(); ++it) {
-        greedy_match(it->second, vec);
+template <typename K, typename T, typename Compare, typename Instrument>
+K radix_tree<K, T, Compare, Instrument>::path_of(radix_tree_node<K, T, Compare>* node) {
+    if (node == root()) {
+        return node->m_key;
+    }
+    radix_tree_node<K, T, Compare>* leaf = node;
+    while (!leaf->m_is_leaf) {
+        leaf = leaf->m_children.begin()->second;
+    }
+    return substr(leaf->m_value->first, 0, node->m_depth + key_length(node->m_key));
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare, Instrument>::compact_resume() {
+    // the path of a node never changes while it lives, so everything up to m_compact_path was moved
+    const auto& view = key_traits::view(m_compact_path);
+    const int len = key_traits::length(view);
+
+    // whether the element at a of the path sorts before the element at b of a label
+    auto before = [&](const int a, const K& label, const int b) {
+        return m_predicate(substr(m_compact_path, a, 1), substr(label, b, 1));
+    };
+
+    radix_tree_node<K, T, Compare>* node = root();
+    int depth = 0;
+
+    while (depth < len) {
+        radix_tree_node<K, T, Compare>* next = nullptr;
+
+        for (auto& it : node->m_children) {
+            if (it.second->m_is_leaf) {
+                continue;
+            }
+            const auto& label = key_traits::view(it.first);
+            const int count = key_traits::common_prefix(label, key_traits::slice(view, depth, len - depth));
+
+            if (count == key_traits::length(label)) {
+                next = it.second;
+                break;
+            }
+            if (count == len - depth) {
+                return it.second;
+            }
+            if (count > 0) {
+                return before(depth + count, it.first, count) ? it.second : subtree_successor(it.second);
+            }
+            if (before(depth, it.first, 0)) {
+                return it.second;
+            }
+        }
+
+        if (next == nullptr) {
+            return subtree_successor(node);
+        }
+        node = next;
+        depth += key_length(node->m_key);
     }
+
+    return next_internal(node);
 }
 
-template <typename K, typename T, typename Compare>
-void radix_tree<K, T, Compare>::erase(iterator it) {
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::erase(iterator it) {
     erase(it->first);
 }
 
-template <typename K, typename T, typename Compare>
-bool radix_tree<K, T, Compare>::erase(const K& key) {
+template <typename K, typename T, typename Compare, typename Instrument>
+bool radix_tree<K, T, Compare, Instrument>::erase(const K& key) {
     if (!m_root) {
         return false;
     }
 
-    radix_tree_node<K, T, Compare>* grandparent;
-    K nul = radix_substr(key, 0, 0);
+    radix_tree_node<K, T, Compare>* child;
 
-    radix_tree_node<K, T, Compare>* child = find_node(key, root(), 0);
+    if constexpr (radix_hashable<K>) {
+        if (m_bloom && !bloom_admits(key)) {
+            return false;
+        }
+        if (m_index) {
+            child = m_index->find(key);
+            if (child == nullptr) {
+                return false;
+            }
+            m_index->erase(key);
+        } else {
+            child = find_node(key, root(), 0);
+        }
+    } else {
+        child = find_node(key, root(), 0);
+    }
 
     if (!child->m_is_leaf) {
         return false;
     }
 
+    radix_tree_node<K, T, Compare>* changed = erase_leaf(child);
+    if (m_scores) {
+        refresh_scores(changed);
+    }
+    if (m_ranks) {
+        refresh_ranks(changed);
+    }
+    return true;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare, Instrument>::erase_leaf(radix_tree_node<K, T, Compare>* child) {
+    radix_tree_node<K, T, Compare>* grandparent;
+
     radix_tree_node<K, T, Compare>* parent = child->m_parent;
-    parent->m_children.erase(nul);
+    parent->m_children.erase(child->m_key);
 
-    delete child;
+    delete_node(child);
 
     m_size--;
+    m_generation++;
+
+    if (m_bloom) {
+        m_bloom->erase();
+    }
 
     if (parent == root()) {
-        return true;
+        return parent;
     }
 
     if (parent->m_children.size() > 1) {
-        return true;
+        return parent;
     }
 
     if (parent->m_children.empty()) {
         grandparent = parent->m_parent;
         grandparent->m_children.erase(parent->m_key);
-        delete parent;
+        delete_node(parent);
     } else {
         grandparent = parent;
     }
 
     if (grandparent == root()) {
-        return true;
+        return grandparent;
     }
 
     if (grandparent->m_children.size() == 1) {
@@ -313,11 +1819,12 @@ bool radix_tree<K, T, Compare>::erase(const K& key) {
         radix_tree_node<K, T, Compare>* uncle = it->second;
 
         if (uncle->m_is_leaf) {
-            return true;
+            return grandparent;
         }
 
+        m_instrument.count(radix_event::merge);
         uncle->m_depth = grandparent->m_depth;
-        uncle->m_key = radix_join(grandparent->m_key, uncle->m_key);
+        uncle->m_key = joined_label(grandparent, uncle);
         uncle->m_parent = grandparent->m_parent;
 
         grandparent->m_children.erase(it);
@@ -325,23 +1832,23 @@ bool radix_tree<K, T, Compare>::erase(const K& key) {
         grandparent->m_parent->m_children.erase(grandparent->m_key);
         grandparent->m_parent->m_children[uncle->m_key] = uncle;
 
-        delete grandparent;
+        delete_node(grandparent);
+        return uncle->m_parent;
     }
-
-    return true;
+    return grandparent;
 }
 
-template <typename K, typename T, typename Compare>
-radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare>::append(radix_tree_node<K, T, Compare>* parent,
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare, Instrument>::append(radix_tree_node<K, T, Compare>* parent,
                                                                   const value_type& val) {
-    K nul = radix_substr(val.first, 0, 0);
+    K nul = substr(val.first, 0, 0);
     radix_tree_node<K, T, Compare>* node_c;
 
-    int depth = parent->m_depth + radix_length(parent->m_key);
-    int len = radix_length(val.first) - depth;
+    int depth = parent->m_depth + key_length(parent->m_key);
+    int len = key_length(val.first) - depth;
 
     if (len == 0) {
-        node_c = new radix_tree_node<K, T, Compare>(val, m_predicate);
+        node_c = new_node(val);
 
         node_c->m_depth = depth;
         node_c->m_parent = parent;
@@ -352,9 +1859,9 @@ radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare>::append(radix_tree_nod
 
         return node_c;
     } else {
-        node_c = new radix_tree_node<K, T, Compare>(val, m_predicate);
+        node_c = new_node();
 
-        K key_sub = radix_substr(val.first, depth, len);
+        K key_sub = substr(val.first, depth, len);
 
         parent->m_children[key_sub] = node_c;
 
@@ -362,7 +1869,7 @@ radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare>::append(radix_tree_nod
         node_c->m_parent = parent;
         node_c->m_key = key_sub;
 
-        auto* node_cc = new radix_tree_node<K, T, Compare>(val, m_predicate);
+        auto* node_cc = new_node(val);
         node_c->m_children[nul] = node_cc;
 
         node_cc->m_depth = depth + len;
@@ -374,38 +1881,35 @@ radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare>::append(radix_tree_nod
     }
 }
 
-template <typename K, typename T, typename Compare>
-radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare>::prepend(radix_tree_node<K, T, Compare>* node,
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare, Instrument>::prepend(radix_tree_node<K, T, Compare>* node,
                                                                    const value_type& val) {
-    const int len1 = radix_length(node->m_key);
-    const int len2 = radix_length(val.first) - node->m_depth;
+    const int len1 = key_length(node->m_key);
+    const int len2 = key_length(val.first) - node->m_depth;
 
-    int count{};
-    for (count = 0; count < len1 && count < len2; count++) {
-        if (!(node->m_key[count] == val.first[count + node->m_depth])) {
-            break;
-        }
-    }
+    const int count = key_traits::common_prefix(key_traits::view(node->m_key),
+                                                key_traits::slice(key_traits::view(val.first), node->m_depth, len2));
 
     assert(count != 0);
 
+    m_instrument.count(radix_event::edge_split);
     node->m_parent->m_children.erase(node->m_key);
 
-    auto* node_a = new radix_tree_node<K, T, Compare>(m_predicate);
+    auto* node_a = new_node();
 
     node_a->m_parent = node->m_parent;
-    node_a->m_key = radix_substr(node->m_key, 0, count);
+    node_a->m_key = substr(node->m_key, 0, count);
     node_a->m_depth = node->m_depth;
     node_a->m_parent->m_children[node_a->m_key] = node_a;
 
     node->m_depth += count;
     node->m_parent = node_a;
-    node->m_key = radix_substr(node->m_key, count, len1 - count);
+    node->m_key = substr(node->m_key, count, len1 - count);
     node->m_parent->m_children[node->m_key] = node;
 
-    K nul = radix_substr(val.first, 0, 0);
+    K nul = substr(val.first, 0, 0);
     if (count == len2) {
-        auto* node_b = new radix_tree_node<K, T, Compare>(val, m_predicate);
+        auto* node_b = new_node(val);
 
         node_b->m_parent = node_a;
         node_b->m_key = nul;
@@ -415,17 +1919,17 @@ radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare>::prepend(radix_tree_no
 
         return node_b;
     } else {
-        auto* node_b = new radix_tree_node<K, T, Compare>(m_predicate);
+        auto* node_b = new_node();
 
         node_b->m_parent = node_a;
         node_b->m_depth = node->m_depth;
-        node_b->m_key = radix_substr(val.first, node_b->m_depth, len2 - count);
+        node_b->m_key = substr(val.first, node_b->m_depth, len2 - count);
         node_b->m_parent->m_children[node_b->m_key] = node_b;
 
-        auto* node_c = new radix_tree_node<K, T, Compare>(val, m_predicate);
+        auto* node_c = new_node(val);
 
         node_c->m_parent = node_b;
-        node_c->m_depth = radix_length(val.first);
+        node_c->m_depth = key_length(val.first);
         node_c->m_key = nul;
         node_c->m_is_leaf = true;
         node_c->m_parent->m_children[nul] = node_c;
@@ -434,61 +1938,544 @@ radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare>::prepend(radix_tree_no
     }
 }
 
-template <typename K, typename T, typename Compare>
-std::pair<typename radix_tree<K, T, Compare>::iterator, bool> radix_tree<K, T, Compare>::insert(const value_type& val) {
+template <typename K, typename T, typename Compare, typename Instrument>
+std::pair<typename radix_tree<K, T, Compare, Instrument>::iterator, bool> radix_tree<K, T, Compare, Instrument>::insert(const value_type& val) {
+    ensure_root(val.first);
+
+    return insert_at(find_node(val.first, root(), 0), val);
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+typename radix_tree<K, T, Compare, Instrument>::iterator radix_tree<K, T, Compare, Instrument>::insert(iterator hint,
+                                                                                               const value_type& val) {
+    if (hint.m_pointee == nullptr) {
+        return insert(val).first;
+    }
+
+    return insert_at(find_node_from(val.first, hint.m_pointee, hint->first), val).first;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class InputIt>
+void radix_tree<K, T, Compare, Instrument>::insert(InputIt first, InputIt last) {
+    iterator hint = end();
+
+    for (; first != last; ++first) {
+        hint = insert(hint, *first);
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class ForwardIt>
+void radix_tree<K, T, Compare, Instrument>::build_parallel(ForwardIt first, ForwardIt last, const unsigned threads) {
+    const unsigned workers = radix_worker_count(threads);
+    if (first == last || workers == 1) {
+        insert(first, last);
+        return;
+    }
+
+    // detach() cannot hand the nodes of a pool being emptied to the parts
+    if (m_compacting) {
+        compact();
+    }
+
+    std::vector<ForwardIt> all;
+    for (ForwardIt it = first; it != last; ++it) {
+        all.push_back(it);
+    }
+
+    std::vector<prefix_group<ForwardIt>> groups;
+    std::vector<ForwardIt> serial;
+    const std::size_t max_size = max_group_size(all.size(), workers);
+    group_by_prefix(std::move(all), [](const ForwardIt& it) -> const K& { return (*it).first; }, max_size, groups,
+                    serial);
+
+    ensure_root((*first).first);
+    // the maxima and counts are recomputed once at the end rather than along every grafted path
+    std::unique_ptr<radix_score_index<K, T, Compare>> scores = std::move(m_scores);
+    std::unique_ptr<radix_rank_index<K, T, Compare>> ranks = std::move(m_ranks);
+
+    std::vector<radix_tree_node<K, T, Compare>*> points;
+    std::vector<std::unique_ptr<radix_tree>> parts;
+    for (const auto& g : groups) {
+        parts.push_back(std::make_unique<radix_tree>(m_predicate));
+        points.push_back(detach(substr((*g.items.front()).first, 0, g.depth), *parts.back()));
+    }
+
+    std::vector<std::vector<radix_tree_node<K, T, Compare>*>> added(groups.size());
+    std::exception_ptr error;
+    try {
+        radix_parallel_for(groups.size(), workers, [&](const std::size_t i) {
+            radix_tree& part = *parts[i];
+            for (const ForwardIt& it : groups[i].items) {
+                std::pair<iterator, bool> ret =
+                    part.insert_at(part.find_node((*it).first, part.root(), groups[i].depth), *it);
+                if (ret.second) {
+                    added[i].push_back(ret.first.m_pointee);
+                }
+            }
+        });
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    for (std::size_t i = 0; i < groups.size(); i++) {
+        m_size += added[i].size();
+        attach(points[i], *parts[i]);
+    }
+    // a point left empty is removed and may merge its parent into a neighbouring point, which must be
+    // filled by then
+    for (radix_tree_node<K, T, Compare>* point : points) {
+        normalize(point);
+    }
+
+    // grafting may have split edges even if nothing was added
+    m_generation++;
+    for (const auto& leaves : added) {
+        for (radix_tree_node<K, T, Compare>* leaf : leaves) {
+            track_insert(leaf);
+        }
+    }
+
+    if (scores) {
+        m_scores = std::move(scores);
+        m_scores->clear();
+        rebuild_score_index(root());
+    }
+    if (ranks) {
+        m_ranks = std::move(ranks);
+        m_ranks->clear();
+        rebuild_rank_index(root());
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    for (const ForwardIt& it : serial) {
+        insert(*it);
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::apply_batch(std::span<const radix_mutation<K, T>> mutations,
+                                                        const unsigned threads) {
+    typedef const radix_mutation<K, T>* item;
+
+    auto apply = [](radix_tree& tree, const radix_mutation<K, T>& m) {
+        if (m.op == radix_mutation_op::erase) {
+            tree.erase(m.key);
+            return;
+        }
+        std::pair<iterator, bool> ret = tree.insert(value_type(m.key, m.value));
+        if (!ret.second && m.op == radix_mutation_op::assign) {
+            ret.first->second = m.value;
+            tree.rescore(ret.first);
+        }
+    };
+
+    const unsigned workers = radix_worker_count(threads);
+    if (mutations.empty() || workers == 1) {
+        for (const radix_mutation<K, T>& m : mutations) {
+            apply(*this, m);
+        }
+        return;
+    }
+
+    // before the index is touched: relocating a leaf looks it up there, see build_parallel()
+    if (m_compacting) {
+        compact();
+    }
+
+    // a stable sort keeps the mutations of each key in order
+    std::vector<item> sorted;
+    sorted.reserve(mutations.size());
+    for (const radix_mutation<K, T>& m : mutations) {
+        sorted.push_back(&m);
+    }
+    std::ranges::stable_sort(sorted, [this](item a, item b) { return m_predicate(a->key, b->key); });
+
+    std::vector<prefix_group<item>> groups;
+    std::vector<item> serial;
+    const std::size_t max_size = max_group_size(sorted.size(), workers);
+    group_by_prefix(std::move(sorted), [](item m) -> const K& { return m->key; }, max_size, groups, serial);
+
+    ensure_root(mutations.front().key);
+    // the maxima and counts are recomputed once at the end, see build_parallel()
+    std::unique_ptr<radix_score_index<K, T, Compare>> scores = std::move(m_scores);
+    std::unique_ptr<radix_rank_index<K, T, Compare>> ranks = std::move(m_ranks);
+
+    std::vector<radix_tree_node<K, T, Compare>*> points;
+    std::vector<std::unique_ptr<radix_tree>> parts;
+    for (const auto& g : groups) {
+        // the leaves of erased keys are freed by the workers, so they leave the index beforehand
+        if constexpr (radix_hashable<K>) {
+            if (m_index) {
+                for (item m : g.items) {
+                    if (m->op == radix_mutation_op::erase) {
+                        m_index->erase(m->key);
+                    }
+                }
+            }
+        }
+
+        parts.push_back(std::make_unique<radix_tree>(m_predicate));
+        points.push_back(detach(substr(g.items.front()->key, 0, g.depth), *parts.back()));
+    }
+
+    struct outcome {
+        std::size_t erased{};
+        // keys for which a leaf was made
+        std::vector<const K*> created;
+    };
+
+    std::vector<outcome> outcomes(groups.size());
+    std::exception_ptr error;
+    try {
+        radix_parallel_for(groups.size(), workers, [&](const std::size_t i) {
+            radix_tree& part = *parts[i];
+            const int depth = groups[i].depth;
+            for (item m : groups[i].items) {
+                radix_tree_node<K, T, Compare>* node = part.find_node(m->key, part.root(), depth);
+                if (m->op == radix_mutation_op::erase) {
+                    if (node->m_is_leaf) {
+                        part.erase_leaf(node);
+                        outcomes[i].erased++;
+                    }
+                    continue;
+                }
+                std::pair<iterator, bool> ret = part.insert_at(node, value_type(m->key, m->value));
+                if (ret.second) {
+                    outcomes[i].created.push_back(&m->key);
+                } else if (m->op == radix_mutation_op::assign) {
+                    ret.first->second = m->value;
+                }
+            }
+        });
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    for (std::size_t i = 0; i < groups.size(); i++) {
+        m_size = m_size + outcomes[i].created.size() - outcomes[i].erased;
+        attach(points[i], *parts[i]);
+    }
+    // a point left empty is removed and may merge its parent into a neighbouring point, which must be
+    // filled by then
+    for (radix_tree_node<K, T, Compare>* point : points) {
+        normalize(point);
+    }
+
+    m_generation++;
+    if constexpr (radix_hashable<K>) {
+        for (const outcome& o : outcomes) {
+            for (const K* key : o.created) {
+                radix_tree_node<K, T, Compare>* leaf = find_node(*key, root(), 0);
+                if (!leaf->m_is_leaf) {
+                    continue;
+                }
+                if (m_index && m_index->find(*key) == nullptr) {
+                    m_index->insert(leaf);
+                }
+                if (m_bloom) {
+                    m_bloom->insert(*key);
+                }
+            }
+            for (std::size_t i = 0; m_bloom && i < o.erased; i++) {
+                m_bloom->erase();
+            }
+        }
+        if (m_bloom && m_bloom->inserted() > m_bloom->capacity()) {
+            rebuild_bloom_filter();
+        }
+    }
+
+    if (scores) {
+        m_scores = std::move(scores);
+        m_scores->clear();
+        rebuild_score_index(root());
+    }
+    if (ranks) {
+        m_ranks = std::move(ranks);
+        m_ranks->clear();
+        rebuild_rank_index(root());
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    for (item m : serial) {
+        apply(*this, *m);
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+template <class Item, class KeyOf>
+void radix_tree<K, T, Compare, Instrument>::group_by_prefix(std::vector<Item> items, KeyOf key_of,
+                                                            const std::size_t max_size,
+                                                            std::vector<prefix_group<Item>>& groups,
+                                                            std::vector<Item>& serial) {
+    typedef typename key_traits::view_type view_type;
+    typedef std::remove_cvref_t<decltype(key_traits::at(std::declval<const view_type&>(), 0))> element;
+
+    std::vector<prefix_group<Item>> pending;
+    pending.push_back(prefix_group<Item>{0, std::move(items)});
+
+    while (!pending.empty()) {
+        prefix_group<Item> g = std::move(pending.back());
+        pending.pop_back();
+
+        if (g.items.size() <= max_size) {
+            groups.push_back(std::move(g));
+            continue;
+        }
+
+        // byte-sized elements are bucketed directly, anything else by a search of the distinct ones
+        std::vector<std::pair<element, std::vector<Item>>> parts;
+        int byte_part[256];
+        std::fill(std::begin(byte_part), std::end(byte_part), -1);
+
+        for (Item& it : g.items) {
+            const auto& key = key_traits::view(key_of(it));
+            if (key_traits::length(key) == g.depth) {
+                serial.push_back(std::move(it));
+                continue;
+            }
+
+            const element e = key_traits::at(key, g.depth);
+            std::size_t part = parts.size();
+            if constexpr ((std::is_integral_v<element> || std::is_same_v<element, std::byte>) && sizeof(element) == 1) {
+                int& slot = byte_part[static_cast<unsigned char>(e)];
+                if (slot < 0) {
+                    slot = static_cast<int>(parts.size());
+                    parts.emplace_back(e, std::vector<Item>());
+                }
+                part = static_cast<std::size_t>(slot);
+            } else {
+                for (std::size_t i = 0; i < parts.size(); i++) {
+                    if (parts[i].first == e) {
+                        part = i;
+                        break;
+                    }
+                }
+                if (part == parts.size()) {
+                    parts.emplace_back(e, std::vector<Item>());
+                }
+            }
+            parts[part].second.push_back(std::move(it));
+        }
+
+        for (auto& part : parts) {
+            pending.push_back(prefix_group<Item>{g.depth + 1, std::move(part.second)});
+        }
+    }
+
+    // the largest groups first, for the workers to pick them up early
+    std::ranges::stable_sort(groups, [](const auto& a, const auto& b) { return a.items.size() > b.items.size(); });
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare, Instrument>::detach(const K& prefix, radix_tree& part) {
+    // `part` frees nodes into its own pool, which later joins ours, not into the one being emptied
+    assert(!m_compacting);
+
+    radix_tree_node<K, T, Compare>* point = graft_point(prefix);
+
+    part.ensure_root(prefix);
+    part.m_root->m_depth = key_length(prefix);
+    part.m_root->m_children = std::move(point->m_children);
+    point->m_children.clear();
+    for (auto& child : part.m_root->m_children) {
+        child.second->m_parent = part.root();
+    }
+
+    return point;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::attach(radix_tree_node<K, T, Compare>* point, radix_tree& part) {
+    point->m_children = std::move(part.m_root->m_children);
+    part.m_root->m_children.clear();
+    for (auto& child : point->m_children) {
+        child.second->m_parent = point;
+    }
+
+    // nodes of this tree may now lie in the chunks of `part`, and slots of this tree may be on the free
+    // list of `part`: the pools are merged before the root of `part` goes
+    m_pool.merge(part.m_pool);
+    delete_node(part.m_root);
+    part.m_root = nullptr;
+    part.m_size = 0;
+    part.clear();
+    if constexpr (requires { m_instrument.merge(part.m_instrument); }) {
+        m_instrument.merge(part.m_instrument);
+    }
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare, Instrument>::graft_point(const K& prefix) {
+    const auto& view = key_traits::view(prefix);
+    const int len = key_traits::length(view);
+
+    radix_tree_node<K, T, Compare>* node = root();
+    int depth = 0;
+
+    while (depth < len) {
+        radix_tree_node<K, T, Compare>* child = nullptr;
+        for (auto& it : node->m_children) {
+            if (!it.second->m_is_leaf && key_traits::at(key_traits::view(it.first), 0) == key_traits::at(view, depth)) {
+                child = it.second;
+                break;
+            }
+        }
+
+        if (child == nullptr) {
+            auto* node_a = new_node();
+            node_a->m_parent = node;
+            node_a->m_depth = depth;
+            node_a->m_key = substr(prefix, depth, len - depth);
+            node->m_children[node_a->m_key] = node_a;
+            return node_a;
+        }
+
+        const int len_child = key_length(child->m_key);
+        const int count = key_traits::common_prefix(key_traits::view(child->m_key), key_traits::slice(view, depth, len));
+
+        if (count < len_child) {
+            m_instrument.count(radix_event::edge_split);
+            node->m_children.erase(child->m_key);
+
+            auto* node_a = new_node();
+            node_a->m_parent = node;
+            node_a->m_depth = depth;
+            node_a->m_key = substr(child->m_key, 0, count);
+            node->m_children[node_a->m_key] = node_a;
+
+            child->m_parent = node_a;
+            child->m_depth = depth + count;
+            child->m_key = substr(child->m_key, count, len_child - count);
+            node_a->m_children[child->m_key] = child;
+
+            child = node_a;
+        }
+
+        node = child;
+        depth += count;
+    }
+
+    return node;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::normalize(radix_tree_node<K, T, Compare>* node) {
+    if (node == root()) {
+        return;
+    }
+
+    radix_tree_node<K, T, Compare>* parent = node->m_parent;
+
+    if (node->m_children.empty()) {
+        parent->m_children.erase(node->m_key);
+        delete_node(node);
+        normalize(parent);
+        return;
+    }
+
+    if (node->m_children.size() > 1 || node->m_children.begin()->second->m_is_leaf) {
+        return;
+    }
+
+    radix_tree_node<K, T, Compare>* child = node->m_children.begin()->second;
+
+    m_instrument.count(radix_event::merge);
+    child->m_depth = node->m_depth;
+    child->m_key = joined_label(node, child);
+    child->m_parent = parent;
+
+    parent->m_children.erase(node->m_key);
+    parent->m_children[child->m_key] = child;
+
+    node->m_children.clear();
+    delete_node(node);
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::ensure_root(const K& key) {
     if (!m_root) {
-        K nul = radix_substr(val.first, 0, 0);
+        K nul = substr(key, 0, 0);
 
-        m_root.reset(new radix_tree_node<K, T, Compare>(m_predicate));
+        m_root = new_node();
         m_root->m_key = nul;
     }
+}
 
-    radix_tree_node<K, T, Compare>* node = find_node(val.first, root(), 0);
-
+template <typename K, typename T, typename Compare, typename Instrument>
+std::pair<typename radix_tree<K, T, Compare, Instrument>::iterator, bool>
+radix_tree<K, T, Compare, Instrument>::insert_at(radix_tree_node<K, T, Compare>* node, const value_type& val) {
     if (node->m_is_leaf) {
         return std::pair<iterator, bool>(iterator{node}, false);
     }
     if (node == root()) {
         m_size++;
-        return std::pair<iterator, bool>(iterator{append(root(), val)}, true);
+        return track_insert(append(root(), val));
     }
     m_size++;
-    int len = radix_length(node->m_key);
-    K key_sub = radix_substr(val.first, node->m_depth, len);
 
-    if (key_sub == node->m_key) {
-        return std::pair<iterator, bool>(iterator{append(node, val)}, true);
+    if (continues_with(val.first, node->m_depth, node->m_key)) {
+        return track_insert(append(node, val));
     }
-    return std::pair<iterator, bool>(iterator{prepend(node, val)}, true);
+    return track_insert(prepend(node, val));
 }
 
-template <typename K, typename T, typename Compare>
-typename radix_tree<K, T, Compare>::iterator radix_tree<K, T, Compare>::find(const K& key) {
+template <typename K, typename T, typename Compare, typename Instrument>
+typename radix_tree<K, T, Compare, Instrument>::iterator radix_tree<K, T, Compare, Instrument>::find(const K& key) {
     if (!m_root) {
         return iterator(nullptr);
     }
 
-    radix_tree_node<K, T, Compare>* node = find_node(key, root(), 0);
+    radix_tree_node<K, T, Compare>* node = nullptr;
+
+    if constexpr (radix_hashable<K>) {
+        if (m_bloom && !bloom_admits(key)) {
+            return iterator(nullptr);
+        }
+        if (m_index) {
+            node = m_index->find(key);
+        }
+    }
+
+    if (node == nullptr && !m_index) {
+        node = find_node(key, root(), 0);
+    }
 
     // if the node is a internal node, return nullptr
-    if (!node->m_is_leaf) {
+    if (node == nullptr || !node->m_is_leaf) {
+        if (m_bloom) {
+            m_bloom_stats.false_positives++;
+        }
         return iterator(nullptr);
     }
 
     return iterator(node);
 }
 
-template <typename K, typename T, typename Compare>
-radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare>::find_node(const K& key, radix_tree_node<K, T, Compare>* node,
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare, Instrument>::find_node(const K& key, radix_tree_node<K, T, Compare>* node,
                                                                      int depth) {
+    m_instrument.count(radix_event::node_visit);
+
     if (node->m_children.empty()) {
         return node;
     }
 
     typename radix_tree_node<K, T, Compare>::it_child it;
-    const int len_key = radix_length(key) - depth;
+    const auto& view = key_traits::view(key);
+    const int len_key = key_traits::length(view) - depth;
 
     for (it = node->m_children.begin(); it != node->m_children.end(); ++it) {
+        m_instrument.count(radix_event::child_scan);
+
         if (len_key == 0) {
             if (it->second->m_is_leaf) {
                 return it->second;
@@ -496,11 +2483,15 @@ radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare>::find_node(const K& ke
             continue;
         }
 
-        if (!it->second->m_is_leaf && key[depth] == it->first[0]) {
-            int len_node = radix_length(it->first);
-            K key_sub = radix_substr(key, depth, len_node);
+        if (it->second->m_is_leaf) {
+            continue;
+        }
 
-            if (key_sub == it->first) {
+        const auto& label = key_traits::view(it->first);
+        if (key_traits::at(view, depth) == key_traits::at(label, 0)) {
+            const int len_node = key_traits::length(label);
+
+            if (key_traits::common_prefix(key_traits::slice(view, depth, len_node), label) == len_node) {
                 return find_node(key, it->second, depth + len_node);
             }
             return it->second;
@@ -510,6 +2501,68 @@ radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare>::find_node(const K& ke
     return node;
 }
 
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare, Instrument>::find_node_from(const K& key,
+                                                                                  radix_tree_node<K, T, Compare>* start,
+                                                                                  const K& start_key) {
+    const int len = common_prefix(key, start_key);
+
+    radix_tree_node<K, T, Compare>* node = start->m_is_leaf ? start->m_parent : start;
+    while (node != root() && node->m_depth + key_length(node->m_key) > len) {
+        node = node->m_parent;
+    }
+
+    return find_node(key, node, node->m_depth + key_length(node->m_key));
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+typename radix_tree<K, T, Compare, Instrument>::iterator radix_tree<K, T, Compare, Instrument>::cursor::seek(const K& key) {
+    if (!m_tree->m_root) {
+        return iterator(nullptr);
+    }
+
+    radix_tree_node<K, T, Compare>* node = start(key);
+    settle(node, key);
+
+    return iterator(node->m_is_leaf ? node : nullptr);
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+std::pair<typename radix_tree<K, T, Compare, Instrument>::iterator, bool>
+radix_tree<K, T, Compare, Instrument>::cursor::insert(const value_type& val) {
+    m_tree->ensure_root(val.first);
+
+    std::pair<iterator, bool> result = m_tree->insert_at(start(val.first), val);
+    settle(result.first.m_pointee, val.first);
+
+    return result;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+radix_tree_node<K, T, Compare>* radix_tree<K, T, Compare, Instrument>::cursor::start(const K& key) {
+    if (m_node == nullptr || m_generation != m_tree->m_generation) {
+        return m_tree->find_node(key, m_tree->root(), 0);
+    }
+
+    return m_tree->find_node_from(key, m_node, m_key);
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+void radix_tree<K, T, Compare, Instrument>::cursor::settle(radix_tree_node<K, T, Compare>* reached, const K& key) {
+    // find_node() stops either below a node whose key is a prefix of `key` or on an edge that diverges from it
+    const bool prefix =
+        !reached->m_is_leaf && (reached == m_tree->root() || continues_with(key, reached->m_depth, reached->m_key));
+
+    m_node = prefix ? reached : reached->m_parent;
+    m_key = key;
+    m_generation = m_tree->m_generation;
+}
+
+template <typename K, typename T, typename Compare, typename Instrument>
+int radix_tree<K, T, Compare, Instrument>::common_prefix(const K& key1, const K& key2) const {
+    return key_traits::common_prefix(key_traits::view(key1), key_traits::view(key2));
+}
+
 /*
 
 (root)
@@ -0,0 +1,508 @@
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// What radix_tree::match_pattern() needs from an automaton: a start state, a transition per key
+// element, and a way to tell accepting states and dead states, from which nothing is accepted.
+template <class A, class Element>
+concept radix_automaton = requires(const A& a, const typename A::state_type s, const Element e) {
+    { a.start() } -> std::same_as<typename A::state_type>;
+    { a.step(s, e) } -> std::same_as<typename A::state_type>;
+    { a.accepts(s) } -> std::convertible_to<bool>;
+    { a.dead(s) } -> std::convertible_to<bool>;
+};
+
+// A deterministic automaton over bytes, compiled from a glob or a regular expression, that matches
+// whole keys. Every state has a table of 256 transitions, and state 0 is the only dead state.
+class radix_dfa {
+  public:
+    typedef std::uint32_t state_type;
+
+    // upper bound on the states of a compiled pattern, beyond which compiling throws std::length_error
+    static constexpr std::size_t max_states = 1 << 14;
+
+    // * matches any run of bytes, ? any byte, [abc], [a-z] and [!a-z] (or [^a-z]) sets of bytes, and a
+    // backslash makes the next byte literal. None of them matches `separator` if there is one, as with
+    // FNM_PATHNAME, so that svc-*/ stops at the first '/'.
+    static radix_dfa glob(std::string_view pattern, std::optional<char> separator = std::nullopt);
+
+    // Literals, ., sets in brackets, \d \w \s, grouping, |, *, + and ?. ^ at the beginning and $ at the
+    // end are allowed and change nothing, as the whole key has to match. Throws std::invalid_argument
+    // for anything else, such as {m,n} or backreferences.
+    static radix_dfa regex(std::string_view pattern);
+
+    [[nodiscard]]
+    state_type start() const {
+        return 1;
+    }
+
+    [[nodiscard]]
+    state_type step(const state_type s, const unsigned char c) const {
+        return m_next[s * 256 + c];
+    }
+
+    [[nodiscard]]
+    bool accepts(const state_type s) const {
+        return m_accepting[s] != 0;
+    }
+
+    [[nodiscard]]
+    bool dead(const state_type s) const {
+        return s == 0;
+    }
+
+    [[nodiscard]]
+    bool matches(std::string_view key) const;
+
+    // the bytes every matching key begins with
+    [[nodiscard]]
+    std::string literal_prefix() const;
+
+    // number of states, the dead one included
+    [[nodiscard]]
+    std::size_t size() const {
+        return m_accepting.size();
+    }
+
+  private:
+    struct nfa;
+    class regex_parser;
+
+    explicit radix_dfa(const nfa& n);
+
+    // parses a bracketed set starting after the '[' at `i`, and returns the position after the ']'
+    static std::size_t parse_set(std::string_view p, std::size_t i, bool glob, std::bitset<256>& set);
+
+    // the bytes of \d, \w and \s, or the escaped byte itself
+    static std::bitset<256> escaped(unsigned char c);
+
+    std::vector<state_type> m_next;
+    std::vector<unsigned char> m_accepting;
+};
+
+// Thompson's construction: every fragment has one entry and one exit state
+struct radix_dfa::nfa {
+    struct state {
+        std::bitset<256> bytes;
+        int next = -1;
+        std::vector<int> eps;
+    };
+
+    struct fragment {
+        int begin;
+        int end;
+    };
+
+    std::vector<state> states;
+    fragment whole{};
+
+    int add() {
+        states.emplace_back();
+        return static_cast<int>(states.size()) - 1;
+    }
+
+    fragment bytes(const std::bitset<256>& set) {
+        const int b = add();
+        const int e = add();
+        states[b].bytes = set;
+        states[b].next = e;
+        return {b, e};
+    }
+
+    fragment empty() {
+        const int b = add();
+        return {b, b};
+    }
+
+    fragment concat(const fragment a, const fragment b) {
+        states[a.end].eps.push_back(b.begin);
+        return {a.begin, b.end};
+    }
+
+    fragment alternate(const fragment a, const fragment b) {
+        const int s = add();
+        const int e = add();
+        states[s].eps = {a.begin, b.begin};
+        states[a.end].eps.push_back(e);
+        states[b.end].eps.push_back(e);
+        return {s, e};
+    }
+
+    fragment star(const fragment a) {
+        const int s = add();
+        const int e = add();
+        states[s].eps = {a.begin, e};
+        states[a.end].eps.push_back(a.begin);
+        states[a.end].eps.push_back(e);
+        return {s, e};
+    }
+
+    fragment plus(const fragment a) {
+        const int e = add();
+        states[a.end].eps.push_back(a.begin);
+        states[a.end].eps.push_back(e);
+        return {a.begin, e};
+    }
+
+    fragment optional(const fragment a) {
+        const int s = add();
+        const int e = add();
+        states[s].eps = {a.begin, e};
+        states[a.end].eps.push_back(e);
+        return {s, e};
+    }
+
+    // adds the states reachable from `set` by epsilon moves, and sorts it
+    void closure(std::vector<int>& set) const {
+        std::vector<char> seen(states.size());
+        std::vector<int> stack(set.begin(), set.end());
+        set.clear();
+        while (!stack.empty()) {
+            const int s = stack.back();
+            stack.pop_back();
+            if (seen[s]) {
+                continue;
+            }
+            seen[s] = 1;
+            set.push_back(s);
+            stack.insert(stack.end(), states[s].eps.begin(), states[s].eps.end());
+        }
+        std::ranges::sort(set);
+    }
+};
+
+class radix_dfa::regex_parser {
+  public:
+    regex_parser(nfa& n, const std::string_view p) : m_nfa(n), m_p(p) {}
+
+    nfa::fragment parse() {
+        if (!m_p.empty() && m_p.front() == '^') {
+            m_i++;
+        }
+        if (m_p.size() > m_i && m_p.back() == '$' && !escaped_at(m_p.size() - 1)) {
+            m_p.remove_suffix(1);
+        }
+        const nfa::fragment f = alternation();
+        if (m_i != m_p.size()) {
+            fail("unbalanced )");
+        }
+        return f;
+    }
+
+  private:
+    nfa& m_nfa;
+    std::string_view m_p;
+    std::size_t m_i{};
+
+    [[noreturn]] void fail(const char* what) const {
+        throw std::invalid_argument(std::string("radix_dfa::regex: ") + what + " at " + std::to_string(m_i) + " in \"" +
+                                    std::string(m_p) + "\"");
+    }
+
+    // whether the byte at `at` is preceded by an odd number of backslashes
+    bool escaped_at(std::size_t at) const {
+        std::size_t n = 0;
+        while (at > n && m_p[at - n - 1] == '\\') {
+            n++;
+        }
+        return n % 2 == 1;
+    }
+
+    nfa::fragment alternation() {
+        nfa::fragment f = concatenation();
+        while (m_i < m_p.size() && m_p[m_i] == '|') {
+            m_i++;
+            f = m_nfa.alternate(f, concatenation());
+        }
+        return f;
+    }
+
+    nfa::fragment concatenation() {
+        nfa::fragment f = m_nfa.empty();
+        while (m_i < m_p.size() && m_p[m_i] != '|' && m_p[m_i] != ')') {
+            f = m_nfa.concat(f, repetition());
+        }
+        return f;
+    }
+
+    nfa::fragment repetition() {
+        nfa::fragment f = atom();
+        while (m_i < m_p.size()) {
+            switch (m_p[m_i]) {
+            case '*': f = m_nfa.star(f); break;
+            case '+': f = m_nfa.plus(f); break;
+            case '?': f = m_nfa.optional(f); break;
+            default: return f;
+            }
+            m_i++;
+        }
+        return f;
+    }
+
+    nfa::fragment atom() {
+        const auto c = static_cast<unsigned char>(m_p[m_i++]);
+        switch (c) {
+        case '(': {
+            const nfa::fragment f = alternation();
+            if (m_i == m_p.size() || m_p[m_i] != ')') {
+                fail("missing )");
+            }
+            m_i++;
+            return f;
+        }
+        case '[': {
+            std::bitset<256> set;
+            m_i = parse_set(m_p, m_i, false, set);
+            return m_nfa.bytes(set);
+        }
+        case '.': return m_nfa.bytes(std::bitset<256>().set());
+        case '\\':
+            if (m_i == m_p.size()) {
+                fail("trailing \\");
+            }
+            if (const char e = m_p[m_i]; (e >= '0' && e <= '9') || e == 'b' || e == 'B') {
+                fail("unsupported escape");
+            }
+            return m_nfa.bytes(escaped(static_cast<unsigned char>(m_p[m_i++])));
+        case '*':
+        case '+':
+        case '?': m_i--; fail("nothing to repeat");
+        case '{':
+        case '}':
+        case '^':
+        case '$': m_i--; fail("unsupported operator");
+        default: {
+            std::bitset<256> set;
+            set.set(c);
+            return m_nfa.bytes(set);
+        }
+        }
+    }
+};
+
+inline std::bitset<256> radix_dfa::escaped(const unsigned char c) {
+    std::bitset<256> set;
+    const auto add_range = [&](const unsigned char first, const unsigned char last) {
+        for (unsigned b = first; b <= last; b++) {
+            set.set(b);
+        }
+    };
+    switch (c) {
+    case 'd': add_range('0', '9'); break;
+    case 'w':
+        add_range('0', '9');
+        add_range('a', 'z');
+        add_range('A', 'Z');
+        set.set('_');
+        break;
+    case 's':
+        for (const unsigned char b : {' ', '\t', '\n', '\r', '\f', '\v'}) {
+            set.set(b);
+        }
+        break;
+    case 'D': set = ~escaped('d'); break;
+    case 'W': set = ~escaped('w'); break;
+    case 'S': set = ~escaped('s'); break;
+    case 'n': set.set('\n'); break;
+    case 't': set.set('\t'); break;
+    case 'r': set.set('\r'); break;
+    default: set.set(c); break;
+    }
+    return set;
+}
+
+inline std::size_t radix_dfa::parse_set(const std::string_view p, std::size_t i, const bool glob,
+                                        std::bitset<256>& set) {
+    set.reset();
+    const bool negate = i < p.size() && (p[i] == '^' || (glob && p[i] == '!'));
+    if (negate) {
+        i++;
+    }
+    // a ']' right at the start is a member
+    for (bool first = true; i < p.size() && (first || p[i] != ']'); first = false) {
+        std::bitset<256> single;
+        auto lo = static_cast<unsigned char>(p[i++]);
+        if (lo == '\\' && i < p.size()) {
+            lo = static_cast<unsigned char>(p[i++]);
+            single = glob ? std::bitset<256>().set(lo) : escaped(lo);
+            if (single.count() != 1) {
+                set |= single;
+                continue;
+            }
+            // such as \n
+            while (!single.test(lo)) {
+                lo++;
+            }
+        }
+        if (i + 1 < p.size() && p[i] == '-' && p[i + 1] != ']') {
+            auto hi = static_cast<unsigned char>(p[i + 1]);
+            i += 2;
+            if (hi == '\\' && i < p.size()) {
+                hi = static_cast<unsigned char>(p[i++]);
+            }
+            if (hi < lo) {
+                throw std::invalid_argument("radix_dfa: reversed range in \"" + std::string(p) + "\"");
+            }
+            for (unsigned b = lo; b <= hi; b++) {
+                set.set(b);
+            }
+        } else {
+            set.set(lo);
+        }
+    }
+    if (i == p.size()) {
+        throw std::invalid_argument("radix_dfa: missing ] in \"" + std::string(p) + "\"");
+    }
+    if (negate) {
+        set.flip();
+    }
+    return i + 1;
+}
+
+inline radix_dfa radix_dfa::glob(const std::string_view pattern, const std::optional<char> separator) {
+    // what the wildcards may match
+    std::bitset<256> any;
+    any.set();
+    if (separator) {
+        any.reset(static_cast<unsigned char>(*separator));
+    }
+
+    nfa n;
+    nfa::fragment f = n.empty();
+    for (std::size_t i = 0; i < pattern.size();) {
+        std::bitset<256> set;
+        const auto c = static_cast<unsigned char>(pattern[i++]);
+        if (c == '*') {
+            f = n.concat(f, n.star(n.bytes(any)));
+            continue;
+        }
+        if (c == '?') {
+            set = any;
+        } else if (c == '[') {
+            // a '[' that does not begin a valid set is a literal, as with fnmatch()
+            try {
+                i = parse_set(pattern, i, true, set);
+                set &= any;
+            } catch (const std::invalid_argument&) {
+                set.reset().set('[');
+            }
+        } else if (c == '\\' && i < pattern.size()) {
+            set.set(static_cast<unsigned char>(pattern[i++]));
+        } else {
+            set.set(c);
+        }
+        f = n.concat(f, n.bytes(set));
+    }
+    n.whole = f;
+    return radix_dfa(n);
+}
+
+inline radix_dfa radix_dfa::regex(const std::string_view pattern) {
+    nfa n;
+    n.whole = regex_parser(n, pattern).parse();
+    return radix_dfa(n);
+}
+
+inline radix_dfa::radix_dfa(const nfa& n) {
+    // subset construction, state 0 being the empty set
+    std::map<std::vector<int>, state_type> ids;
+    std::vector<std::vector<int>> sets{{}};
+    ids[{}] = 0;
+
+    std::vector<int> first{n.whole.begin};
+    n.closure(first);
+    ids[first] = 1;
+    sets.push_back(first);
+
+    for (std::size_t s = 1; s < sets.size(); s++) {
+        m_next.resize(sets.size() * 256);
+        m_accepting.resize(sets.size());
+        m_accepting[s] = std::ranges::binary_search(sets[s], n.whole.end);
+
+        for (unsigned c = 0; c < 256; c++) {
+            std::vector<int> target;
+            for (const int x : sets[s]) {
+                if (n.states[x].next >= 0 && n.states[x].bytes.test(c)) {
+                    target.push_back(n.states[x].next);
+                }
+            }
+            n.closure(target);
+
+            auto [it, added] = ids.try_emplace(std::move(target), static_cast<state_type>(sets.size()));
+            if (added) {
+                if (sets.size() == max_states) {
+                    throw std::length_error("radix_dfa: the pattern needs too many states");
+                }
+                sets.push_back(it->first);
+            }
+            // sets may have grown
+            m_next.resize(sets.size() * 256);
+            m_next[s * 256 + c] = it->second;
+        }
+    }
+    m_accepting.resize(sets.size());
+
+    // states from which nothing is accepted become the dead state, so that a search gives up at once
+    std::vector<char> live(m_accepting.begin(), m_accepting.end());
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (std::size_t s = 1; s < sets.size(); s++) {
+            for (unsigned c = 0; c < 256 && !live[s]; c++) {
+                if (live[m_next[s * 256 + c]]) {
+                    live[s] = 1;
+                    changed = true;
+                }
+            }
+        }
+    }
+    for (state_type& next : m_next) {
+        if (!live[next]) {
+            next = 0;
+        }
+    }
+}
+
+inline bool radix_dfa::matches(const std::string_view key) const {
+    state_type s = start();
+    for (const char c : key) {
+        s = step(s, static_cast<unsigned char>(c));
+        if (dead(s)) {
+            return false;
+        }
+    }
+    return accepts(s);
+}
+
+inline std::string radix_dfa::literal_prefix() const {
+    std::string prefix;
+    state_type s = start();
+    while (!accepts(s) && prefix.size() < size()) {
+        state_type next = 0;
+        unsigned byte = 0;
+        for (unsigned c = 0; c < 256; c++) {
+            if (!dead(step(s, static_cast<unsigned char>(c)))) {
+                if (next != 0) {
+                    return prefix;
+                }
+                next = step(s, static_cast<unsigned char>(c));
+                byte = c;
+            }
+        }
+        if (next == 0) {
+            break;
+        }
+        prefix += static_cast<char>(byte);
+        s = next;
+    }
+    return prefix;
+}
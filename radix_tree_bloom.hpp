@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "radix_tree_hash_index.hpp"
+
+struct radix_bloom_stats {
+    // lookups that consulted the filter
+    std::uint64_t queries{};
+    // lookups answered by the filter alone
+    std::uint64_t rejected{};
+    // lookups let through for a key the tree does not hold
+    std::uint64_t false_positives{};
+    // times the filter was rebuilt from the keys of the tree
+    std::uint64_t rebuilds{};
+
+    [[nodiscard]]
+    double rejection_rate() const {
+        return queries == 0 ? 0.0 : static_cast<double>(rejected) / static_cast<double>(queries);
+    }
+
+    // fraction of the misses that the filter failed to reject
+    [[nodiscard]]
+    double false_positive_rate() const {
+        const std::uint64_t misses = rejected + false_positives;
+        return misses == 0 ? 0.0 : static_cast<double>(false_positives) / static_cast<double>(misses);
+    }
+};
+
+// Blocked Bloom filter over full keys: all the bits of a key lie in one 64-byte block, so a query
+// touches a single cache line. Bits cannot be removed, erased keys stay in the filter until the
+// owner rebuilds it; see stale(). K must satisfy radix_hashable.
+template <typename K>
+class radix_bloom_filter {
+  public:
+    radix_bloom_filter(std::size_t capacity, double fp_rate);
+
+    [[nodiscard]]
+    bool may_contain(const K& key) const;
+
+    void insert(const K& key);
+
+    void erase() { m_stale++; }
+
+    void clear() {
+        std::ranges::fill(m_blocks, block());
+        m_inserted = 0;
+        m_stale = 0;
+    }
+
+    // keys the filter was sized for
+    [[nodiscard]]
+    std::size_t capacity() const {
+        return m_capacity;
+    }
+
+    // keys inserted since the filter was built, erased ones included
+    [[nodiscard]]
+    std::size_t inserted() const {
+        return m_inserted;
+    }
+
+    // erased keys whose bits are still set
+    [[nodiscard]]
+    std::size_t stale() const {
+        return m_stale;
+    }
+
+    [[nodiscard]]
+    double fp_rate() const {
+        return m_fp_rate;
+    }
+
+    [[nodiscard]]
+    unsigned hashes() const {
+        return m_hashes;
+    }
+
+    [[nodiscard]]
+    std::size_t memory_bytes() const {
+        return m_blocks.capacity() * sizeof(block);
+    }
+
+  private:
+    static constexpr unsigned block_bits = 512;
+
+    struct alignas(64) block {
+        std::uint64_t words[block_bits / 64]{};
+    };
+
+    std::vector<block> m_blocks;
+    std::size_t m_capacity;
+    double m_fp_rate;
+    unsigned m_hashes;
+    std::size_t m_inserted{};
+    std::size_t m_stale{};
+
+    // a second, independent hash for the positions inside the block
+    static std::uint64_t remix(std::uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+};
+
+template <typename K>
+radix_bloom_filter<K>::radix_bloom_filter(const std::size_t capacity, const double fp_rate)
+    : m_capacity(std::max<std::size_t>(capacity, 1)), m_fp_rate(std::clamp(fp_rate, 1e-6, 0.5)) {
+    // the optimum of a classic filter, plus a fifth to make up for the uneven load of the blocks
+    const double ln2 = std::log(2.0);
+    const double bits_per_key = -std::log(m_fp_rate) / (ln2 * ln2) * 1.2;
+
+    m_hashes = static_cast<unsigned>(std::clamp(std::lround(bits_per_key / 1.2 * ln2), 1L, 16L));
+
+    const auto bits = static_cast<std::size_t>(std::ceil(bits_per_key * static_cast<double>(m_capacity)));
+    m_blocks.resize((bits + block_bits - 1) / block_bits);
+}
+
+template <typename K>
+bool radix_bloom_filter<K>::may_contain(const K& key) const {
+    const std::uint64_t h1 = std::hash<K>()(key);
+    const std::uint64_t h2 = remix(h1) | 1;
+    const block& b = m_blocks[h1 % m_blocks.size()];
+
+    std::uint64_t h = h2;
+    for (unsigned i = 0; i < m_hashes; i++, h += h2) {
+        const unsigned bit = static_cast<unsigned>(h >> 55);
+        if ((b.words[bit / 64] & (std::uint64_t(1) << (bit % 64))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename K>
+void radix_bloom_filter<K>::insert(const K& key) {
+    const std::uint64_t h1 = std::hash<K>()(key);
+    const std::uint64_t h2 = remix(h1) | 1;
+    block& b = m_blocks[h1 % m_blocks.size()];
+
+    std::uint64_t h = h2;
+    for (unsigned i = 0; i < m_hashes; i++, h += h2) {
+        const unsigned bit = static_cast<unsigned>(h >> 55);
+        b.words[bit / 64] |= std::uint64_t(1) << (bit % 64);
+    }
+    m_inserted++;
+}
@@ -0,0 +1,554 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "radix_tree_key.hpp"
+
+struct radix_burst_stats {
+    std::size_t trie_nodes{};
+    std::size_t buckets{};
+    // keys held by buckets, the others are held by trie nodes
+    std::size_t bucket_keys{};
+    std::size_t heap_bytes{};
+};
+
+// A burst trie: the top of the tree is a trie over single key elements, and below it every small
+// subtree is a bucket, a sorted packed array of the key suffixes and their values. A bucket bursts
+// into a trie node with buckets below it once an insert finds it full. Short keys thus cost a few
+// bytes each instead of several nodes and map entries of radix_tree. Keys are ordered element by
+// element as unsigned bytes, which is the order of std::less for std::string. Any insert or erase
+// invalidates all iterators.
+template <radix_byte_string K, typename T>
+class radix_burst_tree {
+    struct trie_node;
+    struct bucket;
+
+  public:
+    typedef K key_type;
+    typedef T mapped_type;
+    typedef std::size_t size_type;
+
+    class iterator;
+
+    explicit radix_burst_tree(std::size_t burst_threshold = 128)
+        : m_root(std::make_unique<trie_node>()), m_burst_threshold(std::max<std::size_t>(burst_threshold, 1)) {}
+
+    [[nodiscard]]
+    size_type size() const {
+        return m_size;
+    }
+
+    [[nodiscard]]
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    void clear() {
+        m_root = std::make_unique<trie_node>();
+        m_size = 0;
+    }
+
+    iterator begin();
+
+    iterator end() { return iterator(); }
+
+    iterator find(const K& key) { return locate<false>(key).first; }
+
+    std::pair<iterator, bool> insert(const std::pair<const K, T>& val) { return locate<true>(val.first, val.second); }
+
+    T& operator[](const K& key) { return *locate<true>(key).first.m_value; }
+
+    bool erase(const K& key);
+
+    // the element with the longest key that is a prefix of `key`
+    iterator longest_match(const K& key);
+
+    radix_burst_stats stats() const;
+
+  private:
+    struct child {
+        unsigned char label;
+        // exactly one of them is set
+        std::unique_ptr<trie_node> node;
+        std::unique_ptr<bucket> items;
+    };
+
+    struct trie_node {
+        // the value of the key that ends at this node
+        std::optional<T> value;
+        // sorted by label
+        std::vector<child> children;
+    };
+
+    struct bucket {
+        // suffix i is bytes[offsets[i], offsets[i + 1])
+        std::vector<std::uint32_t> offsets{0};
+        std::vector<unsigned char> bytes;
+        std::vector<T> values;
+
+        std::size_t size() const { return values.size(); }
+
+        const unsigned char* suffix(const std::size_t i) const { return bytes.data() + offsets[i]; }
+
+        std::size_t length(const std::size_t i) const { return offsets[i + 1] - offsets[i]; }
+
+        // the first suffix not less than s, and whether it equals s
+        std::pair<std::size_t, bool> lower_bound(const unsigned char* s, std::size_t len) const;
+
+        template <class... Args>
+        void insert(std::size_t pos, const unsigned char* s, std::size_t len, Args&&... args);
+
+        void erase(std::size_t pos);
+    };
+
+    std::unique_ptr<trie_node> m_root;
+    size_type m_size{};
+    std::size_t m_burst_threshold;
+
+    static const unsigned char* bytes_of(const K& key) { return reinterpret_cast<const unsigned char*>(key.data()); }
+
+    static int compare(const unsigned char* a, std::size_t a_len, const unsigned char* b, std::size_t b_len);
+
+    static std::size_t find_child(const trie_node& node, unsigned char label);
+
+    // replaces the bucket of `c` with a trie node holding its suffixes in buckets one element shorter
+    static void burst(child& c);
+
+    // find() if Insert is false, else insert() of a value built from args, unless the key is present
+    template <bool Insert, class... Args>
+    std::pair<iterator, bool> locate(const K& key, Args&&... args);
+};
+
+// A forward iterator in key order. The key of the current element is rebuilt from the path and the
+// bucket suffix, so dereferencing gives a pair of references to the key held by the iterator and to
+// the value held by the tree.
+template <radix_byte_string K, typename T>
+class radix_burst_tree<K, T>::iterator {
+    friend class radix_burst_tree;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<const K&, T&>;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+
+    struct pointer {
+        value_type pair;
+        value_type* operator->() { return &pair; }
+    };
+
+    iterator() = default;
+
+    reference operator*() const { return reference(m_key, *m_value); }
+
+    pointer operator->() const { return pointer{**this}; }
+
+    iterator& operator++();
+
+    iterator operator++(int) {
+        iterator copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    bool operator==(const iterator& other) const { return m_value == other.m_value; }
+
+  private:
+    struct frame {
+        trie_node* node;
+        // the next child to enter
+        std::size_t next;
+    };
+
+    // the trie nodes from the root to the current one
+    std::vector<frame> m_stack;
+    // the labels of the trie nodes below the root on the stack
+    std::vector<unsigned char> m_path;
+    // set when the current element lies in a bucket, the child next - 1 of the top of the stack
+    bucket* m_bucket{};
+    std::size_t m_entry{};
+    T* m_value{};
+    K m_key{};
+
+    // moves to the first element after the subtrees of the stack that were entered so far
+    void advance();
+
+    void set_key();
+};
+
+template <radix_byte_string K, typename T>
+std::pair<std::size_t, bool> radix_burst_tree<K, T>::bucket::lower_bound(const unsigned char* s,
+                                                                         const std::size_t len) const {
+    std::size_t lo = 0;
+    std::size_t hi = size();
+    while (lo < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (compare(suffix(mid), length(mid), s, len) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return {lo, lo < size() && compare(suffix(lo), length(lo), s, len) == 0};
+}
+
+template <radix_byte_string K, typename T>
+template <class... Args>
+void radix_burst_tree<K, T>::bucket::insert(const std::size_t pos, const unsigned char* s, const std::size_t len,
+                                            Args&&... args) {
+    values.emplace(values.begin() + static_cast<std::ptrdiff_t>(pos), std::forward<Args>(args)...);
+    bytes.insert(bytes.begin() + offsets[pos], s, s + len);
+    offsets.insert(offsets.begin() + static_cast<std::ptrdiff_t>(pos) + 1, offsets[pos] + static_cast<std::uint32_t>(len));
+    for (std::size_t i = pos + 2; i < offsets.size(); i++) {
+        offsets[i] += static_cast<std::uint32_t>(len);
+    }
+}
+
+template <radix_byte_string K, typename T>
+void radix_burst_tree<K, T>::bucket::erase(const std::size_t pos) {
+    const std::uint32_t len = offsets[pos + 1] - offsets[pos];
+    values.erase(values.begin() + static_cast<std::ptrdiff_t>(pos));
+    bytes.erase(bytes.begin() + offsets[pos], bytes.begin() + offsets[pos + 1]);
+    offsets.erase(offsets.begin() + static_cast<std::ptrdiff_t>(pos) + 1);
+    for (std::size_t i = pos + 1; i < offsets.size(); i++) {
+        offsets[i] -= len;
+    }
+}
+
+template <radix_byte_string K, typename T>
+int radix_burst_tree<K, T>::compare(const unsigned char* a, const std::size_t a_len, const unsigned char* b,
+                                    const std::size_t b_len) {
+    const std::size_t len = std::min(a_len, b_len);
+    if (len != 0) {
+        if (const int c = std::memcmp(a, b, len); c != 0) {
+            return c;
+        }
+    }
+    return a_len < b_len ? -1 : a_len > b_len ? 1 : 0;
+}
+
+template <radix_byte_string K, typename T>
+std::size_t radix_burst_tree<K, T>::find_child(const trie_node& node, const unsigned char label) {
+    const auto it = std::ranges::lower_bound(node.children, label, std::less<>(), &child::label);
+    return static_cast<std::size_t>(it - node.children.begin());
+}
+
+template <radix_byte_string K, typename T>
+void radix_burst_tree<K, T>::burst(child& c) {
+    auto node = std::make_unique<trie_node>();
+    bucket& items = *c.items;
+
+    // the suffixes are sorted, so every new bucket is filled in order at its end
+    for (std::size_t i = 0; i < items.size(); i++) {
+        const unsigned char* s = items.suffix(i);
+        const std::size_t len = items.length(i);
+        if (len == 0) {
+            node->value.emplace(std::move(items.values[i]));
+            continue;
+        }
+        if (node->children.empty() || node->children.back().label != s[0]) {
+            node->children.push_back(child{s[0], nullptr, std::make_unique<bucket>()});
+        }
+        bucket& target = *node->children.back().items;
+        target.insert(target.size(), s + 1, len - 1, std::move(items.values[i]));
+    }
+
+    c.items.reset();
+    c.node = std::move(node);
+}
+
+template <radix_byte_string K, typename T>
+template <bool Insert, class... Args>
+std::pair<typename radix_burst_tree<K, T>::iterator, bool> radix_burst_tree<K, T>::locate(const K& key,
+                                                                                          Args&&... args) {
+    const unsigned char* s = bytes_of(key);
+    const std::size_t len = key.size();
+
+    iterator it;
+    trie_node* node = m_root.get();
+    it.m_stack.push_back({node, 0});
+    std::size_t depth = 0;
+
+    for (;;) {
+        if (depth == len) {
+            bool inserted = false;
+            if (!node->value) {
+                if constexpr (!Insert) {
+                    return {end(), false};
+                } else {
+                    node->value.emplace(std::forward<Args>(args)...);
+                    m_size++;
+                    inserted = true;
+                }
+            }
+            it.m_value = &*node->value;
+            it.set_key();
+            return {it, inserted};
+        }
+
+        const std::size_t i = find_child(*node, s[depth]);
+        if (i == node->children.size() || node->children[i].label != s[depth]) {
+            if constexpr (!Insert) {
+                return {end(), false};
+            } else {
+                node->children.insert(node->children.begin() + static_cast<std::ptrdiff_t>(i),
+                                      child{s[depth], nullptr, std::make_unique<bucket>()});
+            }
+        }
+
+        child& c = node->children[i];
+        if (c.node) {
+            it.m_stack.back().next = i + 1;
+            it.m_path.push_back(c.label);
+            node = c.node.get();
+            it.m_stack.push_back({node, 0});
+            depth++;
+            continue;
+        }
+
+        bucket& items = *c.items;
+        const auto [pos, found] = items.lower_bound(s + depth + 1, len - depth - 1);
+        bool inserted = false;
+        if (!found) {
+            if constexpr (!Insert) {
+                return {end(), false};
+            } else {
+                if (items.size() >= m_burst_threshold) {
+                    burst(c);
+                    continue;
+                }
+                items.insert(pos, s + depth + 1, len - depth - 1, std::forward<Args>(args)...);
+                m_size++;
+                inserted = true;
+            }
+        }
+
+        it.m_stack.back().next = i + 1;
+        it.m_bucket = &items;
+        it.m_entry = pos;
+        it.m_value = &items.values[pos];
+        it.set_key();
+        return {it, inserted};
+    }
+}
+
+template <radix_byte_string K, typename T>
+typename radix_burst_tree<K, T>::iterator radix_burst_tree<K, T>::begin() {
+    iterator it;
+    it.m_stack.push_back({m_root.get(), 0});
+    if (m_root->value) {
+        it.m_value = &*m_root->value;
+        it.set_key();
+    } else {
+        it.advance();
+    }
+    return it;
+}
+
+template <radix_byte_string K, typename T>
+bool radix_burst_tree<K, T>::erase(const K& key) {
+    const unsigned char* s = bytes_of(key);
+    const std::size_t len = key.size();
+
+    // the trie nodes on the way down, each with the index of the child taken
+    std::vector<std::pair<trie_node*, std::size_t>> path;
+    trie_node* node = m_root.get();
+    std::size_t depth = 0;
+
+    for (;; depth++) {
+        if (depth == len) {
+            if (!node->value) {
+                return false;
+            }
+            node->value.reset();
+            break;
+        }
+
+        const std::size_t i = find_child(*node, s[depth]);
+        if (i == node->children.size() || node->children[i].label != s[depth]) {
+            return false;
+        }
+
+        child& c = node->children[i];
+        path.emplace_back(node, i);
+        if (c.node) {
+            node = c.node.get();
+            continue;
+        }
+
+        bucket& items = *c.items;
+        const auto [pos, found] = items.lower_bound(s + depth + 1, len - depth - 1);
+        if (!found) {
+            return false;
+        }
+        items.erase(pos);
+        if (items.size() == 0) {
+            node->children.erase(node->children.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        path.pop_back();
+        break;
+    }
+    m_size--;
+
+    // drop the trie nodes left with nothing below them
+    while (!path.empty() && !node->value && node->children.empty()) {
+        auto [parent, i] = path.back();
+        path.pop_back();
+        parent->children.erase(parent->children.begin() + static_cast<std::ptrdiff_t>(i));
+        node = parent;
+    }
+    return true;
+}
+
+template <radix_byte_string K, typename T>
+typename radix_burst_tree<K, T>::iterator radix_burst_tree<K, T>::longest_match(const K& key) {
+    const unsigned char* s = bytes_of(key);
+    const std::size_t len = key.size();
+
+    trie_node* node = m_root.get();
+    // the deepest trie node with a value on the way, and its depth
+    trie_node* best = nullptr;
+    std::size_t best_depth = 0;
+
+    for (std::size_t depth = 0;; depth++) {
+        if (node->value) {
+            best = node;
+            best_depth = depth;
+        }
+        if (depth == len) {
+            break;
+        }
+
+        const std::size_t i = find_child(*node, s[depth]);
+        if (i == node->children.size() || node->children[i].label != s[depth]) {
+            break;
+        }
+
+        const child& c = node->children[i];
+        if (c.node) {
+            node = c.node.get();
+            continue;
+        }
+
+        // the longest suffix in the bucket that starts the rest of the key
+        const bucket& items = *c.items;
+        for (std::size_t rest = len - depth; rest-- > 0;) {
+            if (items.lower_bound(s + depth + 1, rest).second) {
+                return find(K(key.data(), key.data() + depth + 1 + rest));
+            }
+        }
+        break;
+    }
+
+    if (best == nullptr) {
+        return end();
+    }
+    return find(K(key.data(), key.data() + best_depth));
+}
+
+template <radix_byte_string K, typename T>
+radix_burst_stats radix_burst_tree<K, T>::stats() const {
+    radix_burst_stats st;
+    std::vector<const trie_node*> pending{m_root.get()};
+
+    while (!pending.empty()) {
+        const trie_node* node = pending.back();
+        pending.pop_back();
+
+        st.trie_nodes++;
+        st.heap_bytes += sizeof(trie_node) + node->children.capacity() * sizeof(child);
+        if (node->value) {
+            st.heap_bytes += radix_heap_bytes(*node->value);
+        }
+
+        for (const child& c : node->children) {
+            if (c.node) {
+                pending.push_back(c.node.get());
+                continue;
+            }
+            const bucket& items = *c.items;
+            st.buckets++;
+            st.bucket_keys += items.size();
+            st.heap_bytes += sizeof(bucket) + items.offsets.capacity() * sizeof(std::uint32_t) +
+                             items.bytes.capacity() + items.values.capacity() * sizeof(T);
+            for (const T& value : items.values) {
+                st.heap_bytes += radix_heap_bytes(value);
+            }
+        }
+    }
+    return st;
+}
+
+template <radix_byte_string K, typename T>
+typename radix_burst_tree<K, T>::iterator& radix_burst_tree<K, T>::iterator::operator++() {
+    if (m_bucket != nullptr && m_entry + 1 < m_bucket->size()) {
+        m_entry++;
+        m_value = &m_bucket->values[m_entry];
+        set_key();
+        return *this;
+    }
+    m_bucket = nullptr;
+    advance();
+    return *this;
+}
+
+template <radix_byte_string K, typename T>
+void radix_burst_tree<K, T>::iterator::advance() {
+    while (!m_stack.empty()) {
+        frame& f = m_stack.back();
+        if (f.next == f.node->children.size()) {
+            m_stack.pop_back();
+            if (!m_stack.empty()) {
+                m_path.pop_back();
+            }
+            continue;
+        }
+
+        child& c = f.node->children[f.next++];
+        if (c.node) {
+            m_path.push_back(c.label);
+            m_stack.push_back({c.node.get(), 0});
+            if (c.node->value) {
+                m_value = &*c.node->value;
+                set_key();
+                return;
+            }
+            continue;
+        }
+
+        // buckets are never left empty
+        m_bucket = c.items.get();
+        m_entry = 0;
+        m_value = &c.items->values[0];
+        set_key();
+        return;
+    }
+
+    m_value = nullptr;
+}
+
+template <radix_byte_string K, typename T>
+void radix_burst_tree<K, T>::iterator::set_key() {
+    typedef typename K::value_type element;
+
+    m_key = K(reinterpret_cast<const element*>(m_path.data()),
+              reinterpret_cast<const element*>(m_path.data() + m_path.size()));
+    if (m_bucket != nullptr) {
+        const frame& f = m_stack.back();
+        m_key.push_back(static_cast<element>(f.node->children[f.next - 1].label));
+        const unsigned char* s = m_bucket->suffix(m_entry);
+        const std::size_t len = m_bucket->length(m_entry);
+        for (std::size_t i = 0; i < len; i++) {
+            m_key.push_back(static_cast<element>(s[i]));
+        }
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "radix_tree_hash_index.hpp"
+
+struct radix_cache_stats {
+    std::uint64_t hits{};
+    std::uint64_t misses{};
+    // lookups that found the tree changed since the previous one, which outdates every entry
+    std::uint64_t invalidations{};
+
+    [[nodiscard]]
+    double hit_rate() const {
+        const std::uint64_t total = hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+    }
+};
+
+// A bounded cache of find() and longest_match() results in front of a tree, evicting with the CLOCK
+// algorithm. Every insert or erase on the tree bumps its generation: an entry holds the generation it
+// was computed at, and is a miss once that is past, and the first to be evicted. The cache is not
+// synchronized: give every reader thread its own, e.g.
+//
+//   thread_local radix_lookup_cache<tree_t> cache(tree, 4096);
+template <class Tree>
+    requires radix_hashable<typename Tree::key_type>
+class radix_lookup_cache {
+  public:
+    typedef typename Tree::key_type key_type;
+    typedef typename Tree::iterator iterator;
+
+    radix_lookup_cache(Tree& tree, std::size_t capacity);
+
+    iterator find(const key_type& key) { return lookup(key, false); }
+
+    iterator longest_match(const key_type& key) { return lookup(key, true); }
+
+    void clear();
+
+    [[nodiscard]]
+    const radix_cache_stats& stats() const {
+        return m_stats;
+    }
+
+    void reset_stats() { m_stats = radix_cache_stats(); }
+
+  private:
+    struct entry {
+        key_type key{};
+        iterator result{};
+        std::uint64_t generation{};
+        bool longest{};
+        bool used{};
+        bool referenced{};
+    };
+
+    Tree& m_tree;
+    std::uint64_t m_generation;
+    std::vector<entry> m_entries;
+    std::size_t m_hand{};
+    // slots of the cached queries, one table per operation
+    std::unordered_map<key_type, std::size_t> m_slots[2];
+    radix_cache_stats m_stats;
+
+    iterator lookup(const key_type& key, bool longest);
+};
+
+template <class Tree>
+    requires radix_hashable<typename Tree::key_type>
+radix_lookup_cache<Tree>::radix_lookup_cache(Tree& tree, const std::size_t capacity)
+    : m_tree(tree), m_generation(tree.generation()), m_entries(capacity == 0 ? 1 : capacity) {
+    m_slots[0].reserve(m_entries.size());
+    m_slots[1].reserve(m_entries.size());
+}
+
+template <class Tree>
+    requires radix_hashable<typename Tree::key_type>
+void radix_lookup_cache<Tree>::clear() {
+    for (entry& e : m_entries) {
+        e = entry();
+    }
+    m_slots[0].clear();
+    m_slots[1].clear();
+    m_hand = 0;
+}
+
+template <class Tree>
+    requires radix_hashable<typename Tree::key_type>
+typename radix_lookup_cache<Tree>::iterator radix_lookup_cache<Tree>::lookup(const key_type& key, const bool longest) {
+    const std::uint64_t generation = m_tree.generation();
+    if (m_generation != generation) {
+        m_generation = generation;
+        m_stats.invalidations++;
+    }
+
+    auto& slots = m_slots[longest ? 1 : 0];
+
+    const auto it = slots.find(key);
+    if (it != slots.end() && m_entries[it->second].generation == generation) {
+        entry& e = m_entries[it->second];
+        e.referenced = true;
+        m_stats.hits++;
+        return e.result;
+    }
+
+    m_stats.misses++;
+    const iterator result = longest ? m_tree.longest_match(key) : m_tree.find(key);
+
+    // an outdated entry of the same query is refreshed in its slot
+    if (it != slots.end()) {
+        entry& e = m_entries[it->second];
+        e.result = result;
+        e.generation = generation;
+        e.referenced = false;
+        return result;
+    }
+
+    // the clock hand passes over recently referenced entries of this generation once before evicting them
+    while (m_entries[m_hand].used && m_entries[m_hand].referenced && m_entries[m_hand].generation == generation) {
+        m_entries[m_hand].referenced = false;
+        m_hand = (m_hand + 1) % m_entries.size();
+    }
+
+    entry& victim = m_entries[m_hand];
+    if (victim.used) {
+        m_slots[victim.longest ? 1 : 0].erase(victim.key);
+    }
+    victim.key = key;
+    victim.result = result;
+    victim.generation = generation;
+    victim.longest = longest;
+    victim.used = true;
+    victim.referenced = false;
+    slots.emplace(key, m_hand);
+
+    m_hand = (m_hand + 1) % m_entries.size();
+
+    return result;
+}
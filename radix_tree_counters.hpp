@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+
+// events counted on the hot paths of radix_tree
+enum class radix_event {
+    node_visit,    // a node entered by find_node or one of the searches
+    child_scan,    // a child examined by the linear loop of find_node or leaf_and_child
+    substr,        // a copy of a part of a key
+    node_alloc,    // a node allocated
+    node_free,     // a node freed
+    edge_split,    // an edge split by prepend
+    merge,         // a node merged with its only child by erase
+};
+
+struct radix_counters {
+    std::uint64_t node_visits{};
+    std::uint64_t child_scans{};
+    std::uint64_t substrs{};
+    std::uint64_t node_allocs{};
+    std::uint64_t node_frees{};
+    std::uint64_t edge_splits{};
+    std::uint64_t merges{};
+
+    void add(const radix_event event, const std::uint64_t n) {
+        switch (event) {
+        case radix_event::node_visit: node_visits += n; break;
+        case radix_event::child_scan: child_scans += n; break;
+        case radix_event::substr: substrs += n; break;
+        case radix_event::node_alloc: node_allocs += n; break;
+        case radix_event::node_free: node_frees += n; break;
+        case radix_event::edge_split: edge_splits += n; break;
+        case radix_event::merge: merges += n; break;
+        }
+    }
+
+    radix_counters& operator+=(const radix_counters& other) {
+        node_visits += other.node_visits;
+        child_scans += other.child_scans;
+        substrs += other.substrs;
+        node_allocs += other.node_allocs;
+        node_frees += other.node_frees;
+        edge_splits += other.edge_splits;
+        merges += other.merges;
+        return *this;
+    }
+};
+
+// Instrumentation policies for the last template parameter of radix_tree.
+
+// the default: counts nothing and takes no space in the tree
+struct radix_no_counters {
+    static constexpr bool enabled = false;
+
+    void count(radix_event, std::uint64_t = 1) {}
+};
+
+// counters owned by each tree
+struct radix_tree_counters {
+    static constexpr bool enabled = true;
+
+    void count(const radix_event event, const std::uint64_t n = 1) { m_counters.add(event, n); }
+
+    radix_counters snapshot() const { return m_counters; }
+    void reset() { m_counters = radix_counters(); }
+
+    // adds the counts of a tree whose nodes this one took over
+    void merge(const radix_tree_counters& other) { m_counters += other.m_counters; }
+
+  private:
+    radix_counters m_counters;
+};
+
+// counters of the calling thread, shared by every tree using this policy
+struct radix_thread_counters {
+    static constexpr bool enabled = true;
+
+    void count(const radix_event event, const std::uint64_t n = 1) { local().add(event, n); }
+
+    static radix_counters snapshot() { return local(); }
+    static void reset() { local() = radix_counters(); }
+
+  private:
+    static radix_counters& local() {
+        thread_local radix_counters counters;
+        return counters;
+    }
+};
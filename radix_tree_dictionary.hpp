@@ -0,0 +1,279 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "radix_tree_key.hpp"
+
+// A static dictionary from byte string keys to dense ids, 0 to size() - 1 in key order, and back, so
+// that range predicates over the keys are range predicates over the ids. It is a radix tree frozen
+// into flat arrays: the edge labels are stored once, back to back, and every node keeps the id of
+// the first key below it. An id is found by one descent along the key, and a key is rebuilt from its
+// id by descending to it and joining the labels on the way, so no copy of the keys is kept. Keys are
+// ordered as unsigned bytes, which is the order of radix_tree with std::less<std::string>; ids are
+// thus the ranks of radix_tree::rank() on a tree of the same keys.
+template <typename K>
+class radix_dictionary {
+  public:
+    typedef radix_key_traits<K> traits;
+    typedef typename traits::view_type view_type;
+    typedef std::uint32_t id_type;
+
+    radix_dictionary() = default;
+
+    // builds the dictionary of the keys or key views in [first, last), which have to be sorted and
+    // distinct and to outlive the construction
+    template <class ForwardIt>
+    radix_dictionary(ForwardIt first, ForwardIt last);
+
+    [[nodiscard]]
+    std::size_t size() const {
+        return m_size;
+    }
+
+    [[nodiscard]]
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    // the id of `key`, nothing if it is not in the dictionary
+    std::optional<id_type> find(const K& key) const;
+
+    // the number of keys less than `key`: the id of `key` or of the next greater key
+    id_type lower_bound(const K& key) const;
+
+    // the key of `id`, std::out_of_range unless id < size()
+    K key(id_type id) const;
+
+    [[nodiscard]]
+    std::size_t memory_bytes() const {
+        return m_labels.capacity() + m_nodes.capacity() * sizeof(node) + m_first_byte.capacity();
+    }
+
+  private:
+    // the terminal flag shares the label length: set when a key ends at the node
+    static constexpr std::uint32_t terminal = 1u << 31;
+
+    // all a descent reads of a node, in one place
+    struct node {
+        // the label is m_labels[label_begin, label_begin + length)
+        std::uint32_t label_begin;
+        std::uint32_t label_length;
+        // the children, numbered breadth first
+        std::uint32_t child_begin;
+        std::uint32_t child_end;
+        // the ids of the keys below the node
+        id_type first_id;
+        id_type end_id;
+
+        std::uint32_t length() const { return label_length & ~terminal; }
+
+        bool is_terminal() const { return (label_length & terminal) != 0; }
+    };
+
+    std::size_t m_size{};
+    std::vector<unsigned char> m_labels;
+    std::vector<node> m_nodes;
+    // the first byte of the label of every node, so the children of a node are searched in one run
+    std::vector<unsigned char> m_first_byte;
+
+    static unsigned char byte(const view_type v, const int i) { return static_cast<unsigned char>(traits::at(v, i)); }
+
+    // the child of n whose label begins with c, 0 if there is none
+    std::uint32_t child(std::uint32_t n, unsigned char c) const;
+};
+
+template <typename K>
+template <class ForwardIt>
+radix_dictionary<K>::radix_dictionary(ForwardIt first, ForwardIt last) {
+    typedef std::remove_cvref_t<decltype(traits::at(std::declval<view_type>(), 0))> element;
+    static_assert(sizeof(element) == 1, "radix_dictionary needs keys of bytes");
+
+    std::vector<view_type> keys;
+    for (; first != last; ++first) {
+        if constexpr (std::is_convertible_v<decltype(*first), view_type>) {
+            keys.push_back(*first);
+        } else {
+            keys.push_back(traits::view(*first));
+        }
+    }
+    if (keys.empty()) {
+        return;
+    }
+    if (keys.size() >= std::numeric_limits<id_type>::max()) {
+        throw std::length_error("radix_dictionary: too many keys");
+    }
+    m_size = keys.size();
+
+    const auto less = [](const view_type a, const view_type b) {
+        const int len = std::min(traits::length(a), traits::length(b));
+        const int same = traits::common_prefix(a, b);
+        return same < len ? byte(a, same) < byte(b, same) : traits::length(a) < traits::length(b);
+    };
+    for (std::size_t i = 1; i < keys.size(); i++) {
+        if (!less(keys[i - 1], keys[i])) {
+            throw std::invalid_argument("radix_dictionary: keys not sorted or not distinct");
+        }
+    }
+
+    // a node is the range of keys [begin, end) below it, which share their first `depth` bytes; the
+    // label runs to the longest common prefix of the range, that of its first and last key
+    struct range {
+        std::uint32_t begin;
+        std::uint32_t end;
+        int depth;
+    };
+    std::vector<range> nodes{{0, static_cast<std::uint32_t>(keys.size()), 0}};
+
+    for (std::size_t n = 0; n < nodes.size(); n++) {
+        const range r = nodes[n];
+        const view_type low = keys[r.begin];
+        const view_type high = keys[r.end - 1];
+        const int low_length = traits::length(low);
+        const int lcp = r.begin + 1 == r.end ? low_length : traits::common_prefix(low, high);
+
+        const bool ends_here = low_length == lcp;
+        node& added = m_nodes.emplace_back();
+        added.label_begin = static_cast<std::uint32_t>(m_labels.size());
+        added.label_length = static_cast<std::uint32_t>(lcp - r.depth) | (ends_here ? terminal : 0);
+        added.first_id = r.begin;
+        added.end_id = r.end;
+        added.child_begin = static_cast<std::uint32_t>(nodes.size());
+        for (int i = r.depth; i < lcp; i++) {
+            m_labels.push_back(byte(low, i));
+        }
+        m_first_byte.push_back(lcp > r.depth ? byte(low, r.depth) : 0);
+
+        // the children split the rest of the range by the byte after the label
+        for (std::uint32_t begin = r.begin + (ends_here ? 1 : 0); begin < r.end;) {
+            const unsigned char c = byte(keys[begin], lcp);
+            std::uint32_t end = begin + 1;
+            while (end < r.end && byte(keys[end], lcp) == c) {
+                end++;
+            }
+            nodes.push_back({begin, end, lcp});
+            begin = end;
+        }
+        m_nodes.back().child_end = static_cast<std::uint32_t>(nodes.size());
+    }
+
+    m_labels.shrink_to_fit();
+    m_nodes.shrink_to_fit();
+    m_first_byte.shrink_to_fit();
+}
+
+template <typename K>
+std::uint32_t radix_dictionary<K>::child(const std::uint32_t n, const unsigned char c) const {
+    const auto first = m_first_byte.begin() + m_nodes[n].child_begin;
+    const auto last = m_first_byte.begin() + m_nodes[n].child_end;
+    const auto it = std::lower_bound(first, last, c);
+    return it != last && *it == c ? static_cast<std::uint32_t>(it - m_first_byte.begin()) : 0;
+}
+
+template <typename K>
+std::optional<typename radix_dictionary<K>::id_type> radix_dictionary<K>::find(const K& key) const {
+    if (m_size == 0) {
+        return std::nullopt;
+    }
+
+    const view_type view = traits::view(key);
+    const int len = traits::length(view);
+    std::uint32_t n = 0;
+    int depth = 0;
+    for (;;) {
+        const node& at = m_nodes[n];
+        const std::uint32_t label_length = at.length();
+        if (depth + static_cast<int>(label_length) > len) {
+            return std::nullopt;
+        }
+        const unsigned char* label = m_labels.data() + at.label_begin;
+        for (std::uint32_t i = 0; i < label_length; i++) {
+            if (byte(view, depth + static_cast<int>(i)) != label[i]) {
+                return std::nullopt;
+            }
+        }
+        depth += static_cast<int>(label_length);
+
+        if (depth == len) {
+            return at.is_terminal() ? std::optional<id_type>(at.first_id) : std::nullopt;
+        }
+        n = child(n, byte(view, depth));
+        if (n == 0) {
+            return std::nullopt;
+        }
+    }
+}
+
+template <typename K>
+typename radix_dictionary<K>::id_type radix_dictionary<K>::lower_bound(const K& key) const {
+    if (m_size == 0) {
+        return 0;
+    }
+
+    const view_type view = traits::view(key);
+    const int len = traits::length(view);
+    std::uint32_t n = 0;
+    int depth = 0;
+    for (;;) {
+        const node& at = m_nodes[n];
+        const std::uint32_t label_length = at.length();
+        const unsigned char* label = m_labels.data() + at.label_begin;
+        for (std::uint32_t i = 0; i < label_length; i++) {
+            // the key ends inside the label or leaves it: the whole subtree is on one side of it
+            if (depth + static_cast<int>(i) == len) {
+                return at.first_id;
+            }
+            if (const unsigned char c = byte(view, depth + static_cast<int>(i)); c != label[i]) {
+                return c < label[i] ? at.first_id : at.end_id;
+            }
+        }
+        depth += static_cast<int>(label_length);
+
+        if (depth == len) {
+            return at.first_id;
+        }
+        // the first child not before the key, whose first key is the bound unless the key is below it
+        const unsigned char c = byte(view, depth);
+        const auto first = m_first_byte.begin() + at.child_begin;
+        const auto last = m_first_byte.begin() + at.child_end;
+        const auto it = std::lower_bound(first, last, c);
+        if (it == last) {
+            return at.end_id;
+        }
+        const auto next = static_cast<std::uint32_t>(it - m_first_byte.begin());
+        if (*it != c) {
+            return m_nodes[next].first_id;
+        }
+        n = next;
+    }
+}
+
+template <typename K>
+K radix_dictionary<K>::key(id_type id) const {
+    if (id >= m_size) {
+        throw std::out_of_range("radix_dictionary::key");
+    }
+
+    K key;
+    std::uint32_t n = 0;
+    for (;;) {
+        const node& at = m_nodes[n];
+        const unsigned char* label = m_labels.data() + at.label_begin;
+        key.insert(key.end(), label, label + at.length());
+        if (at.is_terminal() && at.first_id == id) {
+            return key;
+        }
+        // the last child whose first id is not after `id`
+        const auto first = m_nodes.begin() + at.child_begin;
+        const auto last = m_nodes.begin() + at.child_end;
+        const auto it = std::upper_bound(first, last, id, [](const id_type i, const node& c) { return i < c.first_id; });
+        n = static_cast<std::uint32_t>(it - m_nodes.begin() - 1);
+    }
+}
@@ -0,0 +1,428 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "radix_tree_key.hpp"
+#include "radix_tree_pool.hpp"
+
+struct radix_handle_stats {
+    std::size_t nodes{};
+    // the node slots in use, not counting edge labels too long to live inside the key object
+    std::size_t node_bytes{};
+    std::size_t heap_bytes{};
+};
+
+// A radix tree whose nodes refer to each other by 32-bit handles into a radix_handle_pool instead of
+// by pointers, for trees of many millions of keys. A node is its edge label and four handles: its
+// parent, its first child, its next sibling and its element, if a key ends there. Children form a
+// sibling list sorted by their first element rather than a std::map, and the nodes keep no predicate,
+// so with std::string keys a node takes 48 bytes where a radix_tree_node takes 104 plus its map entry.
+// Keys are ordered as unsigned bytes, like radix_burst_tree. An insert keeps all iterators valid, an
+// erase invalidates them.
+template <radix_byte_string K, typename T>
+class radix_handle_tree {
+    typedef std::uint32_t handle;
+    static constexpr handle none = radix_handle_pool<handle>::none;
+
+    struct node {
+        K label;
+        handle parent{none};
+        handle first_child{none};
+        handle next_sibling{none};
+        handle value{none};
+    };
+
+  public:
+    typedef K key_type;
+    typedef T mapped_type;
+    typedef std::pair<const K, T> value_type;
+    typedef std::size_t size_type;
+
+    class iterator;
+
+    radix_handle_tree() : m_root(m_nodes.create()) {}
+    radix_handle_tree(const radix_handle_tree&) = delete;
+    radix_handle_tree& operator=(const radix_handle_tree&) = delete;
+
+    ~radix_handle_tree() { destroy_all(); }
+
+    [[nodiscard]]
+    size_type size() const {
+        return m_size;
+    }
+
+    [[nodiscard]]
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    void clear() {
+        destroy_all();
+        m_nodes.release();
+        m_values.release();
+        m_root = m_nodes.create();
+        m_size = 0;
+    }
+
+    iterator begin();
+
+    iterator end() { return iterator(this, none); }
+
+    iterator find(const K& key);
+
+    std::pair<iterator, bool> insert(const value_type& val) { return emplace_key(val.first, val.second); }
+
+    T& operator[](const K& key) { return emplace_key(key).first->second; }
+
+    bool erase(const K& key);
+
+    // the element with the longest key that is a prefix of `key`
+    iterator longest_match(const K& key);
+
+    // the elements whose keys start with `key`, in key order
+    void prefix_match(const K& key, std::vector<iterator>& vec);
+
+    radix_handle_stats stats() const;
+
+    // the bytes of one node, against sizeof(radix_tree_node)
+    static constexpr std::size_t node_size() { return sizeof(node); }
+
+  private:
+    radix_handle_pool<node> m_nodes;
+    radix_handle_pool<value_type> m_values;
+    handle m_root;
+    size_type m_size{};
+
+    static unsigned char byte_at(const K& key, const std::size_t i) {
+        return static_cast<unsigned char>(key.data()[i]);
+    }
+
+    // the first child of `h` whose label does not start below `b`, and the child before it
+    std::pair<handle, handle> lower_child(handle h, unsigned char b) const;
+
+    // the child of `h` whose label continues `key` at `depth`, none if there is none
+    handle step(handle h, const K& key, std::size_t depth) const;
+
+    // the node whose path is `key`, none if there is none
+    handle find_node(const K& key) const;
+
+    // the node after `h` in depth-first order, none once the subtree of `top` is left
+    handle next_node(handle h, handle top) const;
+
+    // makes `h` the child of `parent` that follows `prev`, or its first child if `prev` is none
+    void link(const handle parent, const handle prev, const handle h) {
+        (prev == none ? m_nodes[parent].first_child : m_nodes[prev].next_sibling) = h;
+    }
+
+    void unlink(handle h);
+
+    // appends the only child of `h` to it, to restore path compression
+    void merge(handle h);
+
+    template <class... Args>
+    handle make_value(const K& key, Args&&... args) {
+        return m_values.create(std::piecewise_construct, std::forward_as_tuple(key),
+                               std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    // find() that inserts a value built from args if the key is not there
+    template <class... Args>
+    std::pair<iterator, bool> emplace_key(const K& key, Args&&... args);
+
+    void destroy_all();
+};
+
+// A forward iterator in key order: the handle of a node holding an element, along with its tree.
+template <radix_byte_string K, typename T>
+class radix_handle_tree<K, T>::iterator {
+    friend class radix_handle_tree;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<const K, T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type*;
+    using reference = value_type&;
+
+    iterator() = default;
+
+    reference operator*() const { return m_tree->m_values[m_tree->m_nodes[m_node].value]; }
+
+    pointer operator->() const { return &**this; }
+
+    iterator& operator++() {
+        do {
+            m_node = m_tree->next_node(m_node, m_tree->m_root);
+        } while (m_node != none && m_tree->m_nodes[m_node].value == none);
+        return *this;
+    }
+
+    iterator operator++(int) {
+        iterator copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    bool operator==(const iterator& other) const { return m_node == other.m_node; }
+
+  private:
+    iterator(radix_handle_tree* tree, const handle node) : m_tree(tree), m_node(node) {}
+
+    radix_handle_tree* m_tree{};
+    handle m_node{none};
+};
+
+template <radix_byte_string K, typename T>
+std::pair<typename radix_handle_tree<K, T>::handle, typename radix_handle_tree<K, T>::handle>
+radix_handle_tree<K, T>::lower_child(const handle h, const unsigned char b) const {
+    handle prev = none;
+    handle c = m_nodes[h].first_child;
+    while (c != none && byte_at(m_nodes[c].label, 0) < b) {
+        prev = c;
+        c = m_nodes[c].next_sibling;
+    }
+    return {prev, c};
+}
+
+template <radix_byte_string K, typename T>
+typename radix_handle_tree<K, T>::handle radix_handle_tree<K, T>::step(const handle h, const K& key,
+                                                                       const std::size_t depth) const {
+    const handle c = lower_child(h, byte_at(key, depth)).second;
+    if (c == none) {
+        return none;
+    }
+    const K& label = m_nodes[c].label;
+    if (label.size() > key.size() - depth ||
+        !std::equal(label.data(), label.data() + label.size(), key.data() + depth)) {
+        return none;
+    }
+    return c;
+}
+
+template <radix_byte_string K, typename T>
+typename radix_handle_tree<K, T>::handle radix_handle_tree<K, T>::find_node(const K& key) const {
+    handle h = m_root;
+    for (std::size_t depth = 0; depth < key.size(); depth += m_nodes[h].label.size()) {
+        h = step(h, key, depth);
+        if (h == none) {
+            return none;
+        }
+    }
+    return h;
+}
+
+template <radix_byte_string K, typename T>
+typename radix_handle_tree<K, T>::handle radix_handle_tree<K, T>::next_node(handle h, const handle top) const {
+    if (m_nodes[h].first_child != none) {
+        return m_nodes[h].first_child;
+    }
+    while (h != top && m_nodes[h].next_sibling == none) {
+        h = m_nodes[h].parent;
+    }
+    return h == top ? none : m_nodes[h].next_sibling;
+}
+
+template <radix_byte_string K, typename T>
+typename radix_handle_tree<K, T>::iterator radix_handle_tree<K, T>::begin() {
+    iterator it(this, m_root);
+    if (m_nodes[m_root].value == none) {
+        ++it;
+    }
+    return it;
+}
+
+template <radix_byte_string K, typename T>
+typename radix_handle_tree<K, T>::iterator radix_handle_tree<K, T>::find(const K& key) {
+    const handle h = find_node(key);
+    if (h == none || m_nodes[h].value == none) {
+        return end();
+    }
+    return iterator(this, h);
+}
+
+template <radix_byte_string K, typename T>
+template <class... Args>
+std::pair<typename radix_handle_tree<K, T>::iterator, bool> radix_handle_tree<K, T>::emplace_key(const K& key,
+                                                                                                 Args&&... args) {
+    const std::size_t len = key.size();
+    handle h = m_root;
+
+    for (std::size_t depth = 0; depth < len;) {
+        const unsigned char b = byte_at(key, depth);
+        const auto [prev, c] = lower_child(h, b);
+
+        if (c == none || byte_at(m_nodes[c].label, 0) != b) {
+            // the element first, so that a throw leaves no node without one behind
+            const handle value = make_value(key, std::forward<Args>(args)...);
+            handle leaf = none;
+            try {
+                leaf = m_nodes.create(node{K(key.data() + depth, key.data() + len), h, none, c, value});
+            } catch (...) {
+                m_values.destroy(value);
+                throw;
+            }
+            link(h, prev, leaf);
+            m_size++;
+            return {iterator(this, leaf), true};
+        }
+
+        node& child = m_nodes[c];
+        const auto* label = child.label.data();
+        const std::size_t n = std::min(child.label.size(), len - depth);
+        const auto common = static_cast<std::size_t>(std::mismatch(label, label + n, key.data() + depth).first - label);
+
+        if (common < child.label.size()) {
+            // splits the edge after the common part, the pools never move a node so `child` stays valid
+            const handle mid = m_nodes.create(node{K(label, label + common), h, c, child.next_sibling, none});
+            link(h, prev, mid);
+            child.label = K(label + common, label + child.label.size());
+            child.parent = mid;
+            child.next_sibling = none;
+            h = mid;
+        } else {
+            h = c;
+        }
+        depth += common;
+    }
+
+    if (m_nodes[h].value != none) {
+        return {iterator(this, h), false};
+    }
+    m_nodes[h].value = make_value(key, std::forward<Args>(args)...);
+    m_size++;
+    return {iterator(this, h), true};
+}
+
+template <radix_byte_string K, typename T>
+void radix_handle_tree<K, T>::unlink(const handle h) {
+    const handle parent = m_nodes[h].parent;
+    handle prev = none;
+    for (handle c = m_nodes[parent].first_child; c != h; c = m_nodes[c].next_sibling) {
+        prev = c;
+    }
+    link(parent, prev, m_nodes[h].next_sibling);
+}
+
+template <radix_byte_string K, typename T>
+void radix_handle_tree<K, T>::merge(const handle h) {
+    node& n = m_nodes[h];
+    const handle c = n.first_child;
+    const node& child = m_nodes[c];
+
+    for (std::size_t i = 0; i < child.label.size(); i++) {
+        n.label.push_back(child.label.data()[i]);
+    }
+    n.first_child = child.first_child;
+    n.value = child.value;
+    for (handle g = n.first_child; g != none; g = m_nodes[g].next_sibling) {
+        m_nodes[g].parent = h;
+    }
+    m_nodes.destroy(c);
+}
+
+template <radix_byte_string K, typename T>
+bool radix_handle_tree<K, T>::erase(const K& key) {
+    handle h = find_node(key);
+    if (h == none || m_nodes[h].value == none) {
+        return false;
+    }
+    m_values.destroy(m_nodes[h].value);
+    m_nodes[h].value = none;
+    m_size--;
+
+    if (h != m_root && m_nodes[h].first_child == none) {
+        const handle parent = m_nodes[h].parent;
+        unlink(h);
+        m_nodes.destroy(h);
+        h = parent;
+    }
+
+    // a node left with no element and a single child is merged with it
+    const node& n = m_nodes[h];
+    if (h != m_root && n.value == none && n.first_child != none && m_nodes[n.first_child].next_sibling == none) {
+        merge(h);
+    }
+    return true;
+}
+
+template <radix_byte_string K, typename T>
+typename radix_handle_tree<K, T>::iterator radix_handle_tree<K, T>::longest_match(const K& key) {
+    handle h = m_root;
+    handle best = m_nodes[h].value != none ? h : none;
+
+    for (std::size_t depth = 0; depth < key.size(); depth += m_nodes[h].label.size()) {
+        h = step(h, key, depth);
+        if (h == none) {
+            break;
+        }
+        if (m_nodes[h].value != none) {
+            best = h;
+        }
+    }
+    return iterator(this, best);
+}
+
+template <radix_byte_string K, typename T>
+void radix_handle_tree<K, T>::prefix_match(const K& key, std::vector<iterator>& vec) {
+    vec.clear();
+
+    // the rest of the key may end inside the label of the last node
+    handle h = m_root;
+    for (std::size_t depth = 0; depth < key.size(); depth += m_nodes[h].label.size()) {
+        h = lower_child(h, byte_at(key, depth)).second;
+        if (h == none) {
+            return;
+        }
+        const K& label = m_nodes[h].label;
+        const std::size_t n = std::min(label.size(), key.size() - depth);
+        if (!std::equal(label.data(), label.data() + n, key.data() + depth)) {
+            return;
+        }
+    }
+
+    for (handle x = h; x != none; x = next_node(x, h)) {
+        if (m_nodes[x].value != none) {
+            vec.push_back(iterator(this, x));
+        }
+    }
+}
+
+template <radix_byte_string K, typename T>
+radix_handle_stats radix_handle_tree<K, T>::stats() const {
+    radix_handle_stats st;
+    st.nodes = m_nodes.live();
+    st.node_bytes = st.nodes * sizeof(node);
+    st.heap_bytes = m_nodes.memory_bytes() + m_values.memory_bytes();
+
+    for (handle h = m_root; h != none; h = next_node(h, m_root)) {
+        const node& n = m_nodes[h];
+        st.heap_bytes += radix_heap_bytes(n.label);
+        if (n.value != none) {
+            st.heap_bytes += radix_heap_bytes(m_values[n.value].first) + radix_heap_bytes(m_values[n.value].second);
+        }
+    }
+    return st;
+}
+
+template <radix_byte_string K, typename T>
+void radix_handle_tree<K, T>::destroy_all() {
+    std::vector<handle> pending{m_root};
+    while (!pending.empty()) {
+        const handle h = pending.back();
+        pending.pop_back();
+
+        for (handle c = m_nodes[h].first_child; c != none; c = m_nodes[c].next_sibling) {
+            pending.push_back(c);
+        }
+        if (m_nodes[h].value != none) {
+            m_values.destroy(m_nodes[h].value);
+        }
+        m_nodes.destroy(h);
+    }
+}
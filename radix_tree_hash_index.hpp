@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "radix_tree_it.hpp"
+#include "radix_tree_node.hpp"
+
+template <typename K>
+concept radix_hashable = requires(const K& key) {
+    { std::hash<K>()(key) } -> std::convertible_to<std::size_t>;
+};
+
+// Open-addressing table from a full key to its leaf node: linear probing, deletion by backward shift,
+// so no tombstones pile up under churn. The keys are not copied, they are read from the leaves.
+template <typename K, typename T, typename Compare>
+class radix_hash_index {
+  public:
+    radix_hash_index() { m_slots.resize(min_capacity); }
+
+    radix_tree_node<K, T, Compare>* find(const K& key) const;
+
+    void insert(radix_tree_node<K, T, Compare>* leaf);
+
+    void erase(const K& key);
+
+    // points the entry of leaf `from`, which has to be in the index, to `to`, a copy of it
+    void replace(const radix_tree_node<K, T, Compare>* from, radix_tree_node<K, T, Compare>* to);
+
+    void clear() {
+        m_slots.assign(min_capacity, slot());
+        m_size = 0;
+    }
+
+    [[nodiscard]]
+    std::size_t size() const {
+        return m_size;
+    }
+
+    [[nodiscard]]
+    std::size_t memory_bytes() const {
+        return m_slots.capacity() * sizeof(slot);
+    }
+
+  private:
+    static constexpr std::size_t min_capacity = 16;
+
+    struct slot {
+        std::size_t hash{};
+        radix_tree_node<K, T, Compare>* node{};
+    };
+
+    std::vector<slot> m_slots;
+    std::size_t m_size{};
+
+    std::size_t mask() const { return m_slots.size() - 1; }
+
+    void grow();
+};
+
+template <typename K, typename T, typename Compare>
+radix_tree_node<K, T, Compare>* radix_hash_index<K, T, Compare>::find(const K& key) const {
+    const std::size_t hash = std::hash<K>()(key);
+
+    for (std::size_t i = hash & mask();; i = (i + 1) & mask()) {
+        const slot& s = m_slots[i];
+        if (s.node == nullptr) {
+            return nullptr;
+        }
+        if (s.hash == hash && s.node->m_value->first == key) {
+            return s.node;
+        }
+    }
+}
+
+template <typename K, typename T, typename Compare>
+void radix_hash_index<K, T, Compare>::insert(radix_tree_node<K, T, Compare>* leaf) {
+    // at most half full, so probe sequences stay short
+    if (2 * (m_size + 1) > m_slots.size()) {
+        grow();
+    }
+
+    const std::size_t hash = std::hash<K>()(leaf->m_value->first);
+
+    std::size_t i = hash & mask();
+    while (m_slots[i].node != nullptr) {
+        i = (i + 1) & mask();
+    }
+    m_slots[i] = slot{hash, leaf};
+    m_size++;
+}
+
+template <typename K, typename T, typename Compare>
+void radix_hash_index<K, T, Compare>::erase(const K& key) {
+    const std::size_t hash = std::hash<K>()(key);
+
+    std::size_t i = hash & mask();
+    for (;; i = (i + 1) & mask()) {
+        if (m_slots[i].node == nullptr) {
+            return;
+        }
+        if (m_slots[i].hash == hash && m_slots[i].node->m_value->first == key) {
+            break;
+        }
+    }
+
+    // move back every following entry of the cluster that may live in the hole
+    for (std::size_t j = (i + 1) & mask(); m_slots[j].node != nullptr; j = (j + 1) & mask()) {
+        const std::size_t home = m_slots[j].hash & mask();
+        const bool movable = i <= j ? (home <= i || home > j) : (home <= i && home > j);
+        if (movable) {
+            m_slots[i] = m_slots[j];
+            i = j;
+        }
+    }
+    m_slots[i] = slot();
+    m_size--;
+}
+
+template <typename K, typename T, typename Compare>
+void radix_hash_index<K, T, Compare>::replace(const radix_tree_node<K, T, Compare>* from,
+                                              radix_tree_node<K, T, Compare>* to) {
+    const std::size_t hash = std::hash<K>()(to->m_value->first);
+
+    for (std::size_t i = hash & mask(); m_slots[i].node != nullptr; i = (i + 1) & mask()) {
+        if (m_slots[i].node == from) {
+            m_slots[i].node = to;
+            return;
+        }
+    }
+    assert(!"replace() of a leaf that is not in the index");
+}
+
+template <typename K, typename T, typename Compare>
+void radix_hash_index<K, T, Compare>::grow() {
+    std::vector<slot> old(m_slots.size() * 2);
+    old.swap(m_slots);
+
+    for (const slot& s : old) {
+        if (s.node == nullptr) {
+            continue;
+        }
+        std::size_t i = s.hash & mask();
+        while (m_slots[i].node != nullptr) {
+            i = (i + 1) & mask();
+        }
+        m_slots[i] = s;
+    }
+}
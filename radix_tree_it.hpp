@@ -2,15 +2,31 @@
 
 #include <functional>
 
+#include "radix_tree_counters.hpp"
+
 // forward declaration
-template <typename K, typename T, class Compare = std::less<K>>
+template <typename K, typename T, class Compare = std::less<K>, class Instrument = radix_no_counters>
 class radix_tree;
 template <typename K, typename T, class Compare = std::less<K>>
 class radix_tree_node;
+template <typename K, typename T, class Compare = std::less<K>>
+class radix_tree_set_it;
+template <typename K, typename T, class Compare = std::less<K>>
+class radix_hash_index;
+template <typename K, typename T, class Compare = std::less<K>>
+class radix_score_index;
+template <typename K, typename T, class Compare = std::less<K>>
+class radix_rank_index;
+template <typename K, typename T, class Compare = std::less<K>>
+class radix_matcher;
+template <typename Node>
+class radix_node_pool;
 
 template <typename K, typename T, class Compare = std::less<K>>
 class radix_tree_it {
-    friend class radix_tree<K, T, Compare>;
+    template <typename, typename, typename, typename>
+    friend class radix_tree;
+    friend class radix_tree_set_it<K, T, Compare>;
 
   public:
     // Iterator traits
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Key types can be adapted with the free functions radix_substr(), radix_join() and radix_length(),
+// found by argument-dependent lookup (see examples/example2.cpp), or with a specialization of
+// radix_key_traits below, which also avoids building a key for every slice.
+
+template <typename K>
+K radix_substr(const K& key, int begin, int num);
+
+template <>
+inline std::string radix_substr<std::string>(const std::string& key, const int begin, const int num) {
+    return key.substr(begin, num);
+}
+
+template <typename K>
+K radix_join(const K& key1, const K& key2);
+
+template <>
+inline std::string radix_join<std::string>(const std::string& key1, const std::string& key2) {
+    return key1 + key2;
+}
+
+template <typename K>
+int radix_length(const K& key);
+
+template <>
+inline int radix_length<std::string>(const std::string& key) {
+    return static_cast<int>(key.size());
+}
+
+// keys stored as a contiguous run of one-byte elements, which own their storage
+template <typename K>
+concept radix_byte_string = requires(K& key, const K& ckey, const typename K::value_type* p) {
+    { ckey.data() } -> std::convertible_to<const typename K::value_type*>;
+    { ckey.size() } -> std::convertible_to<std::size_t>;
+    K(p, p);
+    key.push_back(*p);
+} && sizeof(typename K::value_type) == 1;
+
+// heap bytes owned by a key or value beyond its sizeof(), used for memory accounting
+template <typename K>
+std::size_t radix_heap_bytes(const K&) {
+    return 0;
+}
+
+template <>
+inline std::size_t radix_heap_bytes<std::string>(const std::string& key) {
+    // short strings live inside the object itself
+    const char* data = key.data();
+    const auto* self = reinterpret_cast<const char*>(&key);
+    if (data >= self && data < self + sizeof(key)) {
+        return 0;
+    }
+    return key.capacity() + 1;
+}
+
+template <>
+inline std::size_t radix_heap_bytes<std::vector<std::uint8_t>>(const std::vector<std::uint8_t>& key) {
+    return key.capacity();
+}
+
+// What the tree needs to know of a key type K. Keys and edge labels held by the tree are owned K, while
+// lookups slice and compare view_type, which should be cheap to copy. Slices are clamped to the view.
+template <typename Traits, typename K>
+concept radix_key_traits_for = requires(const K& key, const typename Traits::view_type& v, const int i) {
+    { Traits::view(key) } -> std::convertible_to<typename Traits::view_type>;
+    { Traits::to_key(v) } -> std::convertible_to<K>;
+    { Traits::length(v) } -> std::convertible_to<int>;
+    { Traits::slice(v, i, i) } -> std::convertible_to<typename Traits::view_type>;
+    { Traits::at(v, i) == Traits::at(v, i) } -> std::convertible_to<bool>;
+    { Traits::common_prefix(v, v) } -> std::convertible_to<int>;
+};
+
+// the fallback: a view is the key itself, sliced with radix_substr()
+template <typename K>
+struct radix_key_traits {
+    typedef K view_type;
+
+    static const K& view(const K& key) { return key; }
+    static const K& to_key(const K& v) { return v; }
+    static int length(const K& v) { return radix_length(v); }
+    static K slice(const K& v, const int begin, const int num) { return radix_substr(v, begin, num); }
+    static auto at(const K& v, const int i) { return v[i]; }
+
+    static int common_prefix(const K& a, const K& b) {
+        const int len = std::min(length(a), length(b));
+        int count = 0;
+        while (count < len && a[count] == b[count]) {
+            count++;
+        }
+        return count;
+    }
+};
+
+// traits of a key stored contiguously, viewed as a pointer and a length
+template <typename K, typename View>
+struct radix_contiguous_key_traits {
+    typedef View view_type;
+
+    static View view(const K& key) { return View(key.data(), key.size()); }
+    static K to_key(const View v) { return K(v.begin(), v.end()); }
+    static int length(const View v) { return static_cast<int>(v.size()); }
+
+    static View slice(const View v, const int begin, const int num) {
+        const std::size_t b = std::min(static_cast<std::size_t>(begin), v.size());
+        return View(v.data() + b, std::min(static_cast<std::size_t>(num), v.size() - b));
+    }
+
+    static auto at(const View v, const int i) { return v[static_cast<std::size_t>(i)]; }
+
+    static int common_prefix(const View a, const View b) {
+        const std::size_t len = std::min(a.size(), b.size());
+        return static_cast<int>(std::mismatch(a.data(), a.data() + len, b.data()).first - a.data());
+    }
+};
+
+template <>
+struct radix_key_traits<std::string> : radix_contiguous_key_traits<std::string, std::string_view> {};
+
+// keys that point into memory owned by the caller, which has to outlive the tree: edge labels are
+// slices of the inserted keys
+template <>
+struct radix_key_traits<std::string_view> : radix_contiguous_key_traits<std::string_view, std::string_view> {};
+
+template <>
+struct radix_key_traits<std::vector<std::uint8_t>>
+    : radix_contiguous_key_traits<std::vector<std::uint8_t>, std::span<const std::uint8_t>> {};
+
+// as std::string_view, the bytes of the keys have to outlive the tree. use with radix_span_less.
+template <>
+struct radix_key_traits<std::span<const std::byte>>
+    : radix_contiguous_key_traits<std::span<const std::byte>, std::span<const std::byte>> {};
+
+// lexicographical order of byte spans, which do not define operator<
+struct radix_span_less {
+    bool operator()(const std::span<const std::byte> a, const std::span<const std::byte> b) const {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+    }
+};
+
+// whether Compare orders keys element by element, as std::less and radix_span_less do, so that two keys
+// compare as their first differing elements do under radix_element_less()
+template <typename K, typename Compare>
+inline constexpr bool radix_lexicographic = std::is_same_v<Compare, std::less<K>> ||
+                                            std::is_same_v<Compare, std::less<>> ||
+                                            std::is_same_v<Compare, radix_span_less>;
+
+// the order of two key elements under a lexicographic Compare: std::less<std::string> takes chars as unsigned
+template <typename E>
+bool radix_element_less(const E a, const E b) {
+    if constexpr (std::is_same_v<E, char>) {
+        return static_cast<unsigned char>(a) < static_cast<unsigned char>(b);
+    } else {
+        return a < b;
+    }
+}
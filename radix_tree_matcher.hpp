@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "radix_tree_key.hpp"
+#include "radix_tree_node.hpp"
+
+// An Aho-Corasick automaton over the bytes of the keys of a radix_tree, made by
+// radix_tree::build_matcher(). It finds every occurrence of every key in a text in one pass, in time
+// linear in the text and the number of matches. The edge labels are expanded into one state per key
+// element, numbered breadth first, with the transitions of each state in one sorted run and a dense
+// table for the root. The matcher refers to the values of the tree, which must not change while it
+// is used. The empty key is never reported.
+template <typename K, typename T, typename Compare>
+class radix_matcher {
+    template <typename, typename, typename, typename>
+    friend class radix_tree;
+
+  public:
+    typedef std::pair<const K, T> value_type;
+
+    // where a scan stopped, so that the next buffer continues the same stream
+    struct scan_state {
+        std::uint32_t state{};
+        // stream offset of the next byte
+        std::uint64_t offset{};
+    };
+
+    // Calls visitor(std::uint64_t begin, value_type&) for every key that occurs in `text`, by the end of
+    // the occurrence and, for occurrences ending at the same byte, longest first. `begin` is the stream
+    // offset of the first byte of the occurrence. Stops when the visitor returns false. Returns the
+    // number of occurrences reported.
+    template <class Visitor>
+    std::size_t scan(std::string_view text, Visitor visitor) const {
+        scan_state state;
+        return scan(state, text, visitor);
+    }
+
+    // scan() of the next buffer of a stream; matches may span buffers
+    template <class Visitor>
+    std::size_t scan(scan_state& state, std::string_view text, Visitor visitor) const;
+
+    // states of the automaton, the root included
+    [[nodiscard]]
+    std::size_t size() const {
+        return m_fail.size();
+    }
+
+    [[nodiscard]]
+    std::size_t memory_bytes() const {
+        return m_edges.capacity() * sizeof(std::uint32_t) + m_labels.capacity() + m_targets.capacity() * 4 +
+               m_fail.capacity() * 4 + m_dict.capacity() * 4 + m_value.capacity() * sizeof(value_type*);
+    }
+
+  private:
+    typedef radix_tree_node<K, T, Compare> node_type;
+    typedef radix_key_traits<K> traits;
+
+    static constexpr std::uint32_t root = 0;
+
+    // the transitions of state s are m_labels / m_targets [m_edges[s], m_edges[s + 1])
+    std::vector<std::uint32_t> m_edges;
+    std::vector<unsigned char> m_labels;
+    std::vector<std::uint32_t> m_targets;
+    // every byte from the root, to the root if there is no key beginning with it
+    std::uint32_t m_root_next[256]{};
+    // the state of the longest proper suffix that is a state as well
+    std::vector<std::uint32_t> m_fail;
+    // the state of the longest proper suffix that is a key, root if there is none
+    std::vector<std::uint32_t> m_dict;
+    std::vector<value_type*> m_value;
+
+    explicit radix_matcher(node_type* top);
+
+    std::uint32_t child(const std::uint32_t s, const unsigned char c) const {
+        const unsigned char* first = m_labels.data() + m_edges[s];
+        const unsigned char* last = m_labels.data() + m_edges[s + 1];
+        const unsigned char* it = std::find(first, last, c);
+        return it == last ? root : m_targets[static_cast<std::size_t>(it - m_labels.data())];
+    }
+
+    std::uint32_t next(std::uint32_t s, const unsigned char c) const {
+        while (s != root) {
+            if (const std::uint32_t t = child(s, c); t != root) {
+                return t;
+            }
+            s = m_fail[s];
+        }
+        return m_root_next[c];
+    }
+};
+
+template <typename K, typename T, typename Compare>
+radix_matcher<K, T, Compare>::radix_matcher(node_type* top) {
+    if (top == nullptr) {
+        m_edges.assign(2, 0);
+        m_fail.assign(1, root);
+        m_dict.assign(1, root);
+        m_value.assign(1, nullptr);
+        return;
+    }
+
+    // a position in the tree: `off` elements of the edge label of `node` are behind it
+    struct position {
+        node_type* node;
+        int off;
+    };
+    std::vector<position> states{{top, traits::length(traits::view(top->m_key))}};
+    m_edges.push_back(0);
+
+    // breadth first, so the transitions of each state are appended in one run, in key order
+    for (std::size_t s = 0; s < states.size(); s++) {
+        const position p = states[s];
+        const auto& label = traits::view(p.node->m_key);
+        const auto add = [&](const position to, const unsigned char c) {
+            m_labels.push_back(c);
+            m_targets.push_back(static_cast<std::uint32_t>(states.size()));
+            states.push_back(to);
+        };
+
+        value_type* value = nullptr;
+        if (p.off < traits::length(label)) {
+            add({p.node, p.off + 1}, static_cast<unsigned char>(traits::at(label, p.off)));
+        } else {
+            for (auto& child : p.node->m_children) {
+                if (child.second->m_is_leaf) {
+                    value = child.second->m_value;
+                } else {
+                    add({child.second, 1}, static_cast<unsigned char>(traits::at(traits::view(child.first), 0)));
+                }
+            }
+        }
+        m_value.push_back(s == root ? nullptr : value);
+        m_edges.push_back(static_cast<std::uint32_t>(m_labels.size()));
+    }
+
+    for (std::uint32_t e = m_edges[root]; e < m_edges[root + 1]; e++) {
+        m_root_next[m_labels[e]] = m_targets[e];
+    }
+
+    // the suffix links of a state only depend on states closer to the root, which come first
+    m_fail.assign(states.size(), root);
+    m_dict.assign(states.size(), root);
+    for (std::uint32_t s = 0; s < states.size(); s++) {
+        for (std::uint32_t e = m_edges[s]; e < m_edges[s + 1]; e++) {
+            const std::uint32_t t = m_targets[e];
+            if (s != root) {
+                m_fail[t] = next(m_fail[s], m_labels[e]);
+            }
+            const std::uint32_t f = m_fail[t];
+            m_dict[t] = m_value[f] != nullptr ? f : m_dict[f];
+        }
+    }
+}
+
+template <typename K, typename T, typename Compare>
+template <class Visitor>
+std::size_t radix_matcher<K, T, Compare>::scan(scan_state& state, const std::string_view text, Visitor visitor) const {
+    std::size_t found = 0;
+    std::uint32_t s = state.state;
+
+    for (std::size_t i = 0; i < text.size(); i++) {
+        s = next(s, static_cast<unsigned char>(text[i]));
+
+        for (std::uint32_t o = m_value[s] != nullptr ? s : m_dict[s]; o != root; o = m_dict[o]) {
+            value_type& val = *m_value[o];
+            const std::uint64_t end = state.offset + i + 1;
+            const auto begin = end - static_cast<std::uint64_t>(traits::length(traits::view(val.first)));
+            found++;
+            bool go_on = true;
+            if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, std::uint64_t, value_type&>>) {
+                visitor(begin, val);
+            } else {
+                go_on = static_cast<bool>(visitor(begin, val));
+            }
+            if (!go_on) {
+                state.state = s;
+                state.offset += i + 1;
+                return found;
+            }
+        }
+    }
+
+    state.state = s;
+    state.offset += text.size();
+    return found;
+}
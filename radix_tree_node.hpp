@@ -4,8 +4,15 @@
 
 template <typename K, typename T, typename Compare>
 class radix_tree_node {
-    friend class radix_tree<K, T, Compare>;
+    template <typename, typename, typename, typename>
+    friend class radix_tree;
     friend class radix_tree_it<K, T, Compare>;
+    friend class radix_tree_set_it<K, T, Compare>;
+    friend class radix_hash_index<K, T, Compare>;
+    friend class radix_score_index<K, T, Compare>;
+    friend class radix_rank_index<K, T, Compare>;
+    friend class radix_matcher<K, T, Compare>;
+    friend class radix_node_pool<radix_tree_node>;
 
     typedef std::pair<const K, T> value_type;
     typedef typename std::map<K, radix_tree_node*, Compare>::iterator it_child;
@@ -14,35 +21,26 @@ class radix_tree_node {
     radix_tree_node(const radix_tree_node&) = delete;
     radix_tree_node& operator=(const radix_tree_node&) = delete;
 
-    ~radix_tree_node();
+    // the children are destroyed by the tree, which owns the storage of all nodes
+    ~radix_tree_node() { delete m_value; }
 
   private:
-    explicit radix_tree_node(Compare& pred)
-        : m_children(std::map<K, radix_tree_node*, Compare>(pred)), m_parent(nullptr), m_value(nullptr), m_depth(0),
-          m_is_leaf(false), m_key(), m_pred(pred) {}
-    radix_tree_node(const value_type& val, Compare& pred);
+    explicit radix_tree_node(const Compare& pred)
+        : m_children(pred), m_parent(nullptr), m_value(nullptr), m_key(), m_depth(0), m_is_leaf(false) {}
+    radix_tree_node(const value_type& val, const Compare& pred);
 
+    // ordered by size, so that no padding is left between the members. the predicate is kept by the tree.
     std::map<K, radix_tree_node*, Compare> m_children;
     radix_tree_node* m_parent;
+    // only set for leaves
     value_type* m_value;
+    K m_key;
     int m_depth;
     bool m_is_leaf;
-    K m_key;
-    Compare& m_pred;
 };
 
 template <typename K, typename T, typename Compare>
-radix_tree_node<K, T, Compare>::radix_tree_node(const value_type& val, Compare& pred)
-    : m_children(std::map<K, radix_tree_node*, Compare>(pred)), m_parent(nullptr), m_value(nullptr), m_depth(0),
-      m_is_leaf(false), m_key(), m_pred(pred) {
+radix_tree_node<K, T, Compare>::radix_tree_node(const value_type& val, const Compare& pred)
+    : m_children(pred), m_parent(nullptr), m_value(nullptr), m_key(), m_depth(0), m_is_leaf(false) {
     m_value = new value_type(val);
 }
-
-template <typename K, typename T, typename Compare>
-radix_tree_node<K, T, Compare>::~radix_tree_node() {
-    it_child it;
-    for (it = m_children.begin(); it != m_children.end(); ++it) {
-        delete it->second;
-    }
-    delete m_value;
-}
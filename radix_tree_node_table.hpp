@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// An open-addressing table from a node address to a value, for the indexes that keep something for
+// every internal node of a radix_tree without growing the nodes: linear probing, deletion by
+// backward shift like radix_hash_index.
+template <typename Node, typename V>
+class radix_node_table {
+  public:
+    radix_node_table() { m_slots.resize(min_capacity); }
+
+    // the value of `node`, nullptr if it has none
+    const V* find(const Node* node) const;
+
+    void set(const Node* node, const V& value);
+
+    void erase(const Node* node);
+
+    // moves the value of `from`, if any, to `to`
+    void replace(const Node* from, const Node* to);
+
+    void clear() {
+        m_slots.assign(min_capacity, slot());
+        m_size = 0;
+    }
+
+    [[nodiscard]]
+    std::size_t size() const {
+        return m_size;
+    }
+
+    [[nodiscard]]
+    std::size_t memory_bytes() const {
+        return m_slots.capacity() * sizeof(slot);
+    }
+
+  private:
+    static constexpr std::size_t min_capacity = 16;
+
+    struct slot {
+        const Node* node{};
+        V value{};
+    };
+
+    std::vector<slot> m_slots;
+    std::size_t m_size{};
+
+    std::size_t mask() const { return m_slots.size() - 1; }
+
+    // nodes come from a pool at a fixed stride, so the address is mixed before it is masked
+    static std::size_t hash(const Node* node) {
+        auto h = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(node));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return static_cast<std::size_t>(h);
+    }
+
+    void grow();
+};
+
+template <typename Node, typename V>
+const V* radix_node_table<Node, V>::find(const Node* node) const {
+    for (std::size_t i = hash(node) & mask();; i = (i + 1) & mask()) {
+        if (m_slots[i].node == node) {
+            return &m_slots[i].value;
+        }
+        if (m_slots[i].node == nullptr) {
+            return nullptr;
+        }
+    }
+}
+
+template <typename Node, typename V>
+void radix_node_table<Node, V>::set(const Node* node, const V& value) {
+    if (2 * (m_size + 1) > m_slots.size()) {
+        grow();
+    }
+
+    std::size_t i = hash(node) & mask();
+    for (; m_slots[i].node != nullptr; i = (i + 1) & mask()) {
+        if (m_slots[i].node == node) {
+            m_slots[i].value = value;
+            return;
+        }
+    }
+    m_slots[i] = slot{node, value};
+    m_size++;
+}
+
+template <typename Node, typename V>
+void radix_node_table<Node, V>::erase(const Node* node) {
+    std::size_t i = hash(node) & mask();
+    for (; m_slots[i].node != node; i = (i + 1) & mask()) {
+        if (m_slots[i].node == nullptr) {
+            return;
+        }
+    }
+
+    for (std::size_t j = (i + 1) & mask(); m_slots[j].node != nullptr; j = (j + 1) & mask()) {
+        const std::size_t home = hash(m_slots[j].node) & mask();
+        const bool movable = i <= j ? (home <= i || home > j) : (home <= i && home > j);
+        if (movable) {
+            m_slots[i] = m_slots[j];
+            i = j;
+        }
+    }
+    m_slots[i] = slot();
+    m_size--;
+}
+
+template <typename Node, typename V>
+void radix_node_table<Node, V>::replace(const Node* from, const Node* to) {
+    if (const V* value = find(from)) {
+        const V moved = *value;
+        erase(from);
+        set(to, moved);
+    }
+}
+
+template <typename Node, typename V>
+void radix_node_table<Node, V>::grow() {
+    std::vector<slot> old(m_slots.size() * 2);
+    old.swap(m_slots);
+
+    for (const slot& s : old) {
+        if (s.node == nullptr) {
+            continue;
+        }
+        std::size_t i = hash(s.node) & mask();
+        while (m_slots[i].node != nullptr) {
+            i = (i + 1) & mask();
+        }
+        m_slots[i] = s;
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// number of workers for a `threads` argument, where 0 means one per hardware thread
+inline unsigned radix_worker_count(const unsigned threads) {
+    if (threads != 0) {
+        return threads;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Runs fn(i) for every i in [0, tasks) on up to `threads` workers, the calling thread included. Tasks
+// are handed out in index order as workers become free, so list the expensive ones first. The first
+// exception thrown by a task is rethrown once all the workers are done.
+template <class F>
+void radix_parallel_for(const std::size_t tasks, const unsigned threads, F fn) {
+    const std::size_t workers = std::min<std::size_t>(radix_worker_count(threads), tasks);
+
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto work = [&] {
+        for (std::size_t i = next++; i < tasks; i = next++) {
+            try {
+                fn(i);
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t i = 1; i < workers; i++) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (std::thread& t : pool) {
+        t.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// Runs fn(i) for every i in [0, tasks) on up to `threads` workers with work stealing: every worker
+// starts on its own contiguous run of tasks, taken from the front, and once that is used up takes
+// tasks from the back of the run of another worker. Neighbouring tasks thus tend to run on the same
+// worker while the load still evens out. Exceptions are handled as by radix_parallel_for().
+template <class F>
+void radix_work_stealing_for(const std::size_t tasks, const unsigned threads, F fn) {
+    const std::size_t workers = std::min<std::size_t>(radix_worker_count(threads), tasks);
+    if (workers == 0) {
+        return;
+    }
+
+    struct run {
+        std::mutex mutex;
+        std::size_t front;
+        std::size_t back;
+    };
+
+    std::vector<run> runs(workers);
+    for (std::size_t w = 0; w < workers; w++) {
+        runs[w].front = tasks * w / workers;
+        runs[w].back = tasks * (w + 1) / workers;
+    }
+
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto take = [&](const std::size_t w, const bool own, std::size_t& task) {
+        const std::lock_guard<std::mutex> lock(runs[w].mutex);
+        if (runs[w].front == runs[w].back) {
+            return false;
+        }
+        task = own ? runs[w].front++ : --runs[w].back;
+        return true;
+    };
+
+    auto work = [&](const std::size_t self) {
+        std::size_t task;
+        for (;;) {
+            bool found = take(self, true, task);
+            for (std::size_t i = 1; !found && i < workers; i++) {
+                found = take((self + i) % workers, false, task);
+            }
+            if (!found) {
+                return;
+            }
+
+            try {
+                fn(task);
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (std::size_t w = 1; w < workers; w++) {
+        pool.emplace_back(work, w);
+    }
+    work(0);
+    for (std::thread& t : pool) {
+        t.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+enum class radix_mutation_op {
+    insert, // as insert(): an existing value is kept
+    assign, // as operator[]: an existing value is replaced
+    erase,
+};
+
+// one change of a batch for radix_tree::apply_batch()
+template <typename K, typename T>
+struct radix_mutation {
+    radix_mutation_op op;
+    K key;
+    T value{};
+};
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Storage for the nodes of one tree. Nodes are carved out of large chunks, so nodes created together
+// lie next to each other and cost no allocator header, and freed nodes are kept on a free list for
+// reuse. Chunks are only given back by release(), once no node is alive. Not thread-safe.
+template <typename Node>
+class radix_node_pool {
+  public:
+    radix_node_pool() = default;
+    radix_node_pool(const radix_node_pool&) = delete;
+    radix_node_pool& operator=(const radix_node_pool&) = delete;
+
+    template <class... Args>
+    Node* create(Args&&... args);
+
+    void destroy(Node* node);
+
+    // takes over the chunks of `other` along with the nodes alive in them, leaving `other` empty
+    void merge(radix_node_pool& other);
+
+    // frees all chunks, which must hold no node
+    void release();
+
+    void swap(radix_node_pool& other) noexcept {
+        std::swap(m_chunks, other.m_chunks);
+        std::swap(m_next, other.m_next);
+        std::swap(m_end, other.m_end);
+        std::swap(m_free, other.m_free);
+        std::swap(m_live, other.m_live);
+        std::swap(m_capacity, other.m_capacity);
+    }
+
+    // whether `node` lies in one of the chunks, in O(log chunks)
+    [[nodiscard]]
+    bool owns(const Node* node) const;
+
+    // nodes created and not destroyed
+    [[nodiscard]]
+    std::size_t live() const {
+        return m_live;
+    }
+
+    // nodes the chunks have room for
+    [[nodiscard]]
+    std::size_t capacity() const {
+        return m_capacity;
+    }
+
+    [[nodiscard]]
+    std::size_t memory_bytes() const {
+        return m_capacity * sizeof(slot);
+    }
+
+  private:
+    union slot {
+        slot* next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    struct chunk {
+        std::unique_ptr<slot[]> slots;
+        std::size_t size;
+    };
+
+    static constexpr std::size_t min_chunk = 64;
+    static constexpr std::size_t max_chunk = 4096;
+
+    // sorted by address, for owns()
+    std::vector<chunk> m_chunks;
+    // the slots of the newest chunk that were never handed out
+    slot* m_next{};
+    slot* m_end{};
+    slot* m_free{};
+    std::size_t m_live{};
+    std::size_t m_capacity{};
+
+    slot* take();
+    void push_free(slot* s) {
+        s->next = m_free;
+        m_free = s;
+    }
+};
+
+template <typename Node>
+template <class... Args>
+Node* radix_node_pool<Node>::create(Args&&... args) {
+    slot* s = take();
+    try {
+        Node* node = ::new (static_cast<void*>(s->storage)) Node(std::forward<Args>(args)...);
+        m_live++;
+        return node;
+    } catch (...) {
+        push_free(s);
+        throw;
+    }
+}
+
+template <typename Node>
+void radix_node_pool<Node>::destroy(Node* node) {
+    node->~Node();
+    push_free(reinterpret_cast<slot*>(node));
+    m_live--;
+}
+
+template <typename Node>
+typename radix_node_pool<Node>::slot* radix_node_pool<Node>::take() {
+    if (m_free != nullptr) {
+        slot* s = m_free;
+        m_free = s->next;
+        return s;
+    }
+
+    if (m_next == m_end) {
+        // chunks double in size, up to a bound, so that small trees stay small
+        const std::size_t size = std::clamp(m_capacity, min_chunk, max_chunk);
+        chunk c{std::make_unique_for_overwrite<slot[]>(size), size};
+        m_next = c.slots.get();
+        m_end = m_next + size;
+        const auto at = std::ranges::upper_bound(m_chunks, m_next, std::less<>(),
+                                                 [](const chunk& x) { return x.slots.get(); });
+        m_chunks.insert(at, std::move(c));
+        m_capacity += size;
+    }
+    return m_next++;
+}
+
+template <typename Node>
+bool radix_node_pool<Node>::owns(const Node* node) const {
+    const auto* s = reinterpret_cast<const slot*>(node);
+    const auto it = std::ranges::upper_bound(m_chunks, s, std::less<>(),
+                                             [](const chunk& x) -> const slot* { return x.slots.get(); });
+    if (it == m_chunks.begin()) {
+        return false;
+    }
+    const chunk& c = *(it - 1);
+    return std::less_equal<>()(c.slots.get(), s) && std::less<>()(s, c.slots.get() + c.size);
+}
+
+template <typename Node>
+void radix_node_pool<Node>::merge(radix_node_pool& other) {
+    if (other.m_chunks.empty()) {
+        return;
+    }
+
+    // only one run of fresh slots is kept, the other one goes on the free list
+    if (m_end - m_next < other.m_end - other.m_next) {
+        std::swap(m_next, other.m_next);
+        std::swap(m_end, other.m_end);
+    }
+    while (other.m_next != other.m_end) {
+        other.push_free(--other.m_end);
+    }
+
+    if (other.m_free != nullptr) {
+        slot* tail = other.m_free;
+        while (tail->next != nullptr) {
+            tail = tail->next;
+        }
+        tail->next = m_free;
+        m_free = other.m_free;
+    }
+
+    std::vector<chunk> chunks;
+    chunks.reserve(m_chunks.size() + other.m_chunks.size());
+    std::ranges::merge(std::make_move_iterator(m_chunks.begin()), std::make_move_iterator(m_chunks.end()),
+                       std::make_move_iterator(other.m_chunks.begin()), std::make_move_iterator(other.m_chunks.end()),
+                       std::back_inserter(chunks), std::less<>(), [](const chunk& x) { return x.slots.get(); },
+                       [](const chunk& x) { return x.slots.get(); });
+    m_chunks = std::move(chunks);
+
+    m_live += other.m_live;
+    m_capacity += other.m_capacity;
+
+    other.m_chunks.clear();
+    other.m_next = nullptr;
+    other.m_end = nullptr;
+    other.m_free = nullptr;
+    other.m_live = 0;
+    other.m_capacity = 0;
+}
+
+template <typename Node>
+void radix_node_pool<Node>::release() {
+    assert(m_live == 0);
+    m_chunks.clear();
+    m_next = nullptr;
+    m_end = nullptr;
+    m_free = nullptr;
+    m_capacity = 0;
+}
+
+// Storage addressed by 32-bit handles rather than pointers, for radix_handle_tree. Slots live in chunks
+// that double in size up to max_chunk and never move, so a handle is turned into its slot with a shift
+// and a mask, and references stay valid as the pool grows. Freed slots are reused first. Like
+// radix_node_pool, objects alive on release() are not destroyed. Not thread-safe.
+template <typename V>
+class radix_handle_pool {
+  public:
+    typedef std::uint32_t handle;
+    static constexpr handle none = std::numeric_limits<handle>::max();
+
+    radix_handle_pool() = default;
+    radix_handle_pool(const radix_handle_pool&) = delete;
+    radix_handle_pool& operator=(const radix_handle_pool&) = delete;
+
+    template <class... Args>
+    handle create(Args&&... args);
+
+    void destroy(handle h);
+
+    V& operator[](const handle h) { return *std::launder(reinterpret_cast<V*>(slot_of(h).storage)); }
+
+    const V& operator[](const handle h) const {
+        return *std::launder(reinterpret_cast<const V*>(slot_of(h).storage));
+    }
+
+    // frees all chunks, which must hold no object
+    void release();
+
+    // objects created and not destroyed
+    [[nodiscard]]
+    std::size_t live() const {
+        return m_live;
+    }
+
+    [[nodiscard]]
+    std::size_t memory_bytes() const {
+        return m_capacity * sizeof(slot);
+    }
+
+  private:
+    union slot {
+        handle next;
+        alignas(V) unsigned char storage[sizeof(V)];
+    };
+
+    static constexpr unsigned min_shift = 6;
+    static constexpr unsigned max_shift = 12;
+
+    std::vector<std::unique_ptr<slot[]>> m_chunks;
+    // the slots below it were handed out at least once
+    handle m_used{};
+    handle m_free{none};
+    std::size_t m_live{};
+    std::size_t m_capacity{};
+
+    // chunk c holds 2^min_shift slots for c = 0 and 2^(min_shift + c - 1) after it, up to 2^max_shift
+    static std::size_t chunk_size(const std::size_t c) {
+        return std::size_t{1} << std::min<std::size_t>(c == 0 ? min_shift : min_shift + c - 1, max_shift);
+    }
+
+    slot& slot_of(const handle h) const {
+        if (h >> max_shift == 0) {
+            const auto c = static_cast<std::size_t>(std::bit_width(h >> min_shift));
+            return m_chunks[c][c == 0 ? h : h - (handle{1} << (min_shift + c - 1))];
+        }
+        return m_chunks[(h >> max_shift) + (max_shift - min_shift)][h & ((handle{1} << max_shift) - 1)];
+    }
+};
+
+template <typename V>
+template <class... Args>
+typename radix_handle_pool<V>::handle radix_handle_pool<V>::create(Args&&... args) {
+    handle h = m_free;
+    if (h != none) {
+        m_free = slot_of(h).next;
+    } else {
+        if (m_used == none) {
+            throw std::length_error("radix_handle_pool: out of 32-bit handles");
+        }
+        if (m_used == m_capacity) {
+            const std::size_t size = chunk_size(m_chunks.size());
+            m_chunks.push_back(std::make_unique_for_overwrite<slot[]>(size));
+            m_capacity += size;
+        }
+        h = m_used++;
+    }
+
+    try {
+        ::new (static_cast<void*>(slot_of(h).storage)) V(std::forward<Args>(args)...);
+    } catch (...) {
+        slot_of(h).next = m_free;
+        m_free = h;
+        throw;
+    }
+    m_live++;
+    return h;
+}
+
+template <typename V>
+void radix_handle_pool<V>::destroy(const handle h) {
+    (*this)[h].~V();
+    slot_of(h).next = m_free;
+    m_free = h;
+    m_live--;
+}
+
+template <typename V>
+void radix_handle_pool<V>::release() {
+    assert(m_live == 0);
+    m_chunks.clear();
+    m_used = 0;
+    m_free = none;
+    m_capacity = 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+#include "radix_tree_node.hpp"
+#include "radix_tree_node_table.hpp"
+
+// The number of elements below every internal node, for radix_tree::rank() and select(). The owner
+// calls update() on every internal node whose subtree changed, bottom up, as for radix_score_index.
+template <typename K, typename T, typename Compare>
+class radix_rank_index {
+  public:
+    typedef radix_tree_node<K, T, Compare> node_type;
+
+    // 1 for a leaf, the entry of an internal node otherwise
+    [[nodiscard]]
+    std::size_t count(const node_type* node) const {
+        if (node->m_is_leaf) {
+            return 1;
+        }
+        const std::size_t* count = m_count.find(node);
+        assert(count != nullptr);
+        return *count;
+    }
+
+    // recomputes the entry of an internal node from its children, and returns whether it changed
+    bool update(const node_type* node);
+
+    void erase(const node_type* node) { m_count.erase(node); }
+
+    // moves the entry of `from`, if any, to `to`, a copy of it
+    void replace(const node_type* from, const node_type* to) { m_count.replace(from, to); }
+
+    void clear() { m_count.clear(); }
+
+    [[nodiscard]]
+    std::size_t memory_bytes() const {
+        return m_count.memory_bytes();
+    }
+
+  private:
+    radix_node_table<node_type, std::size_t> m_count;
+};
+
+template <typename K, typename T, typename Compare>
+bool radix_rank_index<K, T, Compare>::update(const node_type* node) {
+    std::size_t count = 0;
+    for (const auto& child : node->m_children) {
+        count += this->count(child.second);
+    }
+
+    if (const std::size_t* old = m_count.find(node); old != nullptr && *old == count) {
+        return false;
+    }
+    m_count.set(node, count);
+    return true;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <utility>
+
+#include "radix_tree_node.hpp"
+#include "radix_tree_node_table.hpp"
+
+// The highest score below every internal node, for radix_tree::top_k(). The score of an element is
+// computed from its value by a function given by the owner, and the owner calls update() on every
+// internal node whose subtree changed, bottom up. Kept in a table keyed by the node address, so that
+// the nodes do not grow when no index is used.
+template <typename K, typename T, typename Compare>
+class radix_score_index {
+  public:
+    typedef radix_tree_node<K, T, Compare> node_type;
+    typedef std::function<double(const std::pair<const K, T>&)> score_function;
+
+    explicit radix_score_index(score_function score) : m_score(std::move(score)) {}
+
+    // the score of a leaf, or the highest score below an internal node that has an entry
+    [[nodiscard]]
+    double max(const node_type* node) const {
+        if (node->m_is_leaf) {
+            return m_score(*node->m_value);
+        }
+        const double* max = m_max.find(node);
+        assert(max != nullptr);
+        return *max;
+    }
+
+    // recomputes the entry of an internal node from its children, and returns whether it changed
+    bool update(const node_type* node);
+
+    void erase(const node_type* node) { m_max.erase(node); }
+
+    // moves the entry of `from`, if any, to `to`, a copy of it
+    void replace(const node_type* from, const node_type* to) { m_max.replace(from, to); }
+
+    void clear() { m_max.clear(); }
+
+    [[nodiscard]]
+    std::size_t size() const {
+        return m_max.size();
+    }
+
+    [[nodiscard]]
+    std::size_t memory_bytes() const {
+        return m_max.memory_bytes();
+    }
+
+  private:
+    score_function m_score;
+    radix_node_table<node_type, double> m_max;
+};
+
+template <typename K, typename T, typename Compare>
+bool radix_score_index<K, T, Compare>::update(const node_type* node) {
+    double max = -std::numeric_limits<double>::infinity();
+    for (const auto& child : node->m_children) {
+        max = std::max(max, this->max(child.second));
+    }
+
+    if (const double* old = m_max.find(node); old != nullptr && *old == max) {
+        return false;
+    }
+    m_max.set(node, max);
+    return true;
+}
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "radix_tree_it.hpp"
+#include "radix_tree_key.hpp"
+#include "radix_tree_node.hpp"
+
+enum class radix_set_op { intersection, difference, symmetric_difference, union_ };
+
+// Lazily walks two trees side by side, edge by edge. Subtrees that have no counterpart in the other
+// tree are either skipped as a whole or emitted without any further comparison.
+template <typename K, typename T, typename Compare>
+class radix_tree_set_it {
+    template <typename, typename, typename, typename>
+    friend class radix_tree;
+
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::pair<const K, T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type*;
+    using reference = value_type&;
+
+    radix_tree_set_it() = default;
+
+    std::pair<const K, T>& operator*() const;
+    std::pair<const K, T>* operator->() const;
+    const radix_tree_set_it& operator++();
+    radix_tree_set_it operator++(int);
+
+    bool operator!=(const radix_tree_set_it& lhs) const;
+    bool operator==(const radix_tree_set_it& lhs) const;
+
+    // the element of the left / right tree, end() of that tree if the key is absent there
+    radix_tree_it<K, T, Compare> left() const { return radix_tree_it<K, T, Compare>(m_left); }
+    radix_tree_it<K, T, Compare> right() const { return radix_tree_it<K, T, Compare>(m_right); }
+
+  private:
+    typedef radix_tree_node<K, T, Compare> node_type;
+    typedef typename node_type::it_child it_child;
+    typedef radix_key_traits<K> traits;
+
+    // a position in each tree at the same key depth: `off` elements of the node's edge label are consumed.
+    // a frame with one side missing stands for a whole subtree of the other side.
+    struct frame {
+        node_type* left;
+        int left_off;
+        node_type* right;
+        int right_off;
+    };
+
+    // outgoing branches of one side of a frame: either the rest of an edge label or the node's children
+    struct side_cursor {
+        node_type* node;
+        int off;
+        bool mid_edge;
+        bool done;
+        it_child it;
+
+        side_cursor(node_type* n, int o)
+            : node(n), off(o), mid_edge(o < traits::length(traits::view(n->m_key))), done(false), it(n->m_children.begin()) {}
+
+        bool empty() const { return mid_edge ? done : it == node->m_children.end(); }
+        node_type* target() const { return mid_edge ? node : it->second; }
+        int target_off() const { return mid_edge ? off : 0; }
+        bool is_leaf() const { return !mid_edge && it->second->m_is_leaf; }
+        const K& label() const { return mid_edge ? node->m_key : it->first; }
+        void next() {
+            if (mid_edge) {
+                done = true;
+            } else {
+                ++it;
+            }
+        }
+    };
+
+    radix_tree_set_it(radix_set_op op, Compare pred, node_type* left, node_type* right);
+
+    bool emits(bool has_left, bool has_right) const;
+    bool keeps(bool is_left) const;
+    // whether the element of `lhs` at `lhs_off` sorts before the one of `rhs` at `rhs_off`. Only an order
+    // that is not lexicographic needs keys built of them.
+    bool less(const K& lhs, int lhs_off, const K& rhs, int rhs_off) const;
+
+    void push_side(node_type* node, bool is_left);
+    void expand(const frame& f);
+    void advance();
+
+    radix_set_op m_op{radix_set_op::intersection};
+    Compare m_pred{};
+    std::vector<frame> m_stack;
+    node_type* m_left{};
+    node_type* m_right{};
+};
+
+// a pair of set iterators usable in a range-based for loop
+template <typename K, typename T, typename Compare>
+struct radix_set_view {
+    radix_tree_set_it<K, T, Compare> m_begin;
+
+    radix_tree_set_it<K, T, Compare> begin() const { return m_begin; }
+    radix_tree_set_it<K, T, Compare> end() const { return radix_tree_set_it<K, T, Compare>(); }
+};
+
+template <typename K, typename T, typename Compare>
+radix_tree_set_it<K, T, Compare>::radix_tree_set_it(radix_set_op op, Compare pred, node_type* left, node_type* right)
+    : m_op(op), m_pred(pred) {
+    if (left != nullptr && right != nullptr) {
+        m_stack.push_back(frame{left, 0, right, 0});
+    } else if (left != nullptr) {
+        push_side(left, true);
+    } else if (right != nullptr) {
+        push_side(right, false);
+    }
+    advance();
+}
+
+template <typename K, typename T, typename Compare>
+bool radix_tree_set_it<K, T, Compare>::emits(const bool has_left, const bool has_right) const {
+    switch (m_op) {
+    case radix_set_op::intersection: return has_left && has_right;
+    case radix_set_op::difference: return has_left && !has_right;
+    case radix_set_op::symmetric_difference: return has_left != has_right;
+    case radix_set_op::union_: return true;
+    }
+    return false;
+}
+
+template <typename K, typename T, typename Compare>
+bool radix_tree_set_it<K, T, Compare>::keeps(const bool is_left) const {
+    return emits(is_left, !is_left);
+}
+
+template <typename K, typename T, typename Compare>
+bool radix_tree_set_it<K, T, Compare>::less(const K& lhs, const int lhs_off, const K& rhs, const int rhs_off) const {
+    if constexpr (radix_lexicographic<K, Compare>) {
+        return radix_element_less(traits::at(traits::view(lhs), lhs_off), traits::at(traits::view(rhs), rhs_off));
+    } else {
+        return m_pred(traits::to_key(traits::slice(traits::view(lhs), lhs_off, 1)),
+                      traits::to_key(traits::slice(traits::view(rhs), rhs_off, 1)));
+    }
+}
+
+template <typename K, typename T, typename Compare>
+void radix_tree_set_it<K, T, Compare>::push_side(node_type* node, const bool is_left) {
+    if (!keeps(is_left)) {
+        return;
+    }
+
+    if (is_left) {
+        m_stack.push_back(frame{node, 0, nullptr, 0});
+    } else {
+        m_stack.push_back(frame{nullptr, 0, node, 0});
+    }
+}
+
+template <typename K, typename T, typename Compare>
+void radix_tree_set_it<K, T, Compare>::expand(const frame& f) {
+    node_type* left = f.left;
+    node_type* right = f.right;
+    int left_off = f.left_off;
+    int right_off = f.right_off;
+
+    const auto& left_key = traits::view(left->m_key);
+    const auto& right_key = traits::view(right->m_key);
+    const int left_len = traits::length(left_key);
+    const int right_len = traits::length(right_key);
+
+    const int common = traits::common_prefix(traits::slice(left_key, left_off, left_len - left_off),
+                                             traits::slice(right_key, right_off, right_len - right_off));
+    left_off += common;
+    right_off += common;
+
+    // branches are pushed in key order and reversed afterwards, so the smallest key is popped first
+    const std::size_t mark = m_stack.size();
+
+    if (left_off < left_len && right_off < right_len) {
+        // the edge labels diverge: the two subtrees share no key
+        if (less(left->m_key, left_off, right->m_key, right_off)) {
+            push_side(left, true);
+            push_side(right, false);
+        } else {
+            push_side(right, false);
+            push_side(left, true);
+        }
+    } else {
+        side_cursor lhs(left, left_off);
+        side_cursor rhs(right, right_off);
+
+        while (!lhs.empty() || !rhs.empty()) {
+            if (rhs.empty()) {
+                push_side(lhs.target(), true);
+                lhs.next();
+            } else if (lhs.empty()) {
+                push_side(rhs.target(), false);
+                rhs.next();
+            } else if (lhs.is_leaf() && rhs.is_leaf()) {
+                m_stack.push_back(frame{lhs.target(), 0, rhs.target(), 0});
+                lhs.next();
+                rhs.next();
+            } else if (lhs.is_leaf()) {
+                push_side(lhs.target(), true);
+                lhs.next();
+            } else if (rhs.is_leaf()) {
+                push_side(rhs.target(), false);
+                rhs.next();
+            } else if (traits::at(traits::view(lhs.label()), lhs.target_off()) ==
+                       traits::at(traits::view(rhs.label()), rhs.target_off())) {
+                m_stack.push_back(frame{lhs.target(), lhs.target_off(), rhs.target(), rhs.target_off()});
+                lhs.next();
+                rhs.next();
+            } else if (less(lhs.label(), lhs.target_off(), rhs.label(), rhs.target_off())) {
+                push_side(lhs.target(), true);
+                lhs.next();
+            } else {
+                push_side(rhs.target(), false);
+                rhs.next();
+            }
+        }
+    }
+
+    std::reverse(m_stack.begin() + static_cast<std::ptrdiff_t>(mark), m_stack.end());
+}
+
+template <typename K, typename T, typename Compare>
+void radix_tree_set_it<K, T, Compare>::advance() {
+    m_left = nullptr;
+    m_right = nullptr;
+
+    while (!m_stack.empty()) {
+        const frame f = m_stack.back();
+        m_stack.pop_back();
+
+        node_type* node = f.left != nullptr ? f.left : f.right;
+
+        if (f.left != nullptr && f.right != nullptr) {
+            if (f.left->m_is_leaf) {
+                assert(f.right->m_is_leaf);
+                if (emits(true, true)) {
+                    m_left = f.left;
+                    m_right = f.right;
+                    return;
+                }
+                continue;
+            }
+            expand(f);
+        } else if (node->m_is_leaf) {
+            m_left = f.left;
+            m_right = f.right;
+            return;
+        } else {
+            // a subtree without counterpart, emitted as a block
+            const std::size_t mark = m_stack.size();
+            for (it_child it = node->m_children.begin(); it != node->m_children.end(); ++it) {
+                m_stack.push_back(f.left != nullptr ? frame{it->second, 0, nullptr, 0} : frame{nullptr, 0, it->second, 0});
+            }
+            std::reverse(m_stack.begin() + static_cast<std::ptrdiff_t>(mark), m_stack.end());
+        }
+    }
+}
+
+template <typename K, typename T, typename Compare>
+std::pair<const K, T>& radix_tree_set_it<K, T, Compare>::operator*() const {
+    return *(m_left != nullptr ? m_left : m_right)->m_value;
+}
+
+template <typename K, typename T, typename Compare>
+std::pair<const K, T>* radix_tree_set_it<K, T, Compare>::operator->() const {
+    return (m_left != nullptr ? m_left : m_right)->m_value;
+}
+
+template <typename K, typename T, typename Compare>
+const radix_tree_set_it<K, T, Compare>& radix_tree_set_it<K, T, Compare>::operator++() {
+    advance();
+    return *this;
+}
+
+template <typename K, typename T, typename Compare>
+radix_tree_set_it<K, T, Compare> radix_tree_set_it<K, T, Compare>::operator++(int) {
+    radix_tree_set_it copy(*this);
+    ++(*this);
+    return copy;
+}
+
+template <typename K, typename T, typename Compare>
+bool radix_tree_set_it<K, T, Compare>::operator!=(const radix_tree_set_it& lhs) const {
+    return !(*this == lhs);
+}
+
+template <typename K, typename T, typename Compare>
+bool radix_tree_set_it<K, T, Compare>::operator==(const radix_tree_set_it& lhs) const {
+    return m_left == lhs.m_left && m_right == lhs.m_right;
+}
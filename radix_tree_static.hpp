@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// A radix tree of N string keys fixed at compile time, for small keyword tables such as HTTP methods
+// or header names. It is built by a constexpr constructor into arrays held by value, with no
+// pointers and no allocation, so a constexpr table costs nothing at startup and its lookups can be
+// inlined and folded. The elements are kept sorted by key, and every node refers to the range of
+// elements below it, whose first key spells its label. The lookups have the names and results of
+// those of radix_tree, with an iterator into the sorted elements.
+template <typename T, std::size_t N>
+class radix_static_tree {
+  public:
+    typedef std::string_view key_type;
+    typedef T mapped_type;
+    typedef std::pair<std::string_view, T> value_type;
+    typedef std::size_t size_type;
+    typedef const value_type* const_iterator;
+    typedef const_iterator iterator;
+
+    // builds the tree of the elements, which need distinct keys; std::invalid_argument otherwise,
+    // which fails the compilation of a constexpr tree
+    constexpr explicit radix_static_tree(const std::array<value_type, N>& elements);
+
+    [[nodiscard]]
+    constexpr size_type size() const {
+        return N;
+    }
+
+    [[nodiscard]]
+    constexpr bool empty() const {
+        return N == 0;
+    }
+
+    // the elements in key order
+    constexpr const_iterator begin() const { return m_elements.data(); }
+
+    constexpr const_iterator end() const { return m_elements.data() + N; }
+
+    constexpr const_iterator find(std::string_view key) const;
+
+    [[nodiscard]]
+    constexpr bool contains(std::string_view key) const {
+        return find(key) != end();
+    }
+
+    [[nodiscard]]
+    constexpr size_type count(std::string_view key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    // the element with the longest key that is a prefix of `key`, end() if there is none
+    constexpr const_iterator longest_match(std::string_view key) const;
+
+    // the elements whose keys begin with `key`: they are next to each other in key order
+    constexpr std::pair<const_iterator, const_iterator> prefix_range(std::string_view key) const;
+
+    void prefix_match(std::string_view key, std::vector<const_iterator>& vec) const;
+
+  private:
+    // a node has at most one child per byte and either ends a key or has two children, apart from the
+    // root, so N keys need at most 2N nodes and the root
+    static constexpr std::size_t max_nodes = 2 * N + 1;
+
+    struct node {
+        // the elements below the node, of which the first spells the label
+        std::uint32_t first{};
+        std::uint32_t last{};
+        // the label is the bytes [depth, depth + length) of the first key
+        std::uint32_t depth{};
+        std::uint32_t length{};
+        // the children, numbered breadth first
+        std::uint32_t child_begin{};
+        std::uint32_t child_end{};
+        // set when the first key ends at the node
+        bool terminal{};
+    };
+
+    std::array<value_type, N> m_elements;
+    std::array<node, max_nodes> m_nodes{};
+    // the first byte of the label of every node, what a descent compares
+    std::array<unsigned char, max_nodes> m_first_byte{};
+
+    constexpr std::string_view label(const node& n) const {
+        return m_elements[n.first].first.substr(n.depth, n.length);
+    }
+
+    // the child of n whose label begins with c, 0 if there is none. The children are few, so they are
+    // scanned in order rather than searched.
+    constexpr std::uint32_t child(const node& n, const unsigned char c) const {
+        for (std::uint32_t i = n.child_begin; i < n.child_end; i++) {
+            if (m_first_byte[i] >= c) {
+                return m_first_byte[i] == c ? i : 0;
+            }
+        }
+        return 0;
+    }
+};
+
+template <typename T, std::size_t N>
+constexpr radix_static_tree<T, N>::radix_static_tree(const std::array<value_type, N>& elements) : m_elements(elements) {
+    static_assert(N < (std::size_t{1} << 31), "radix_static_tree: too many keys");
+
+    std::sort(m_elements.begin(), m_elements.end(),
+              [](const value_type& a, const value_type& b) { return a.first < b.first; });
+    for (std::size_t i = 1; i < N; i++) {
+        if (m_elements[i - 1].first == m_elements[i].first) {
+            throw std::invalid_argument("radix_static_tree: duplicate key");
+        }
+    }
+    if constexpr (N == 0) {
+        return;
+    }
+
+    // breadth first, as in radix_dictionary: a node is the range of elements that share their first
+    // `depth` bytes, and its label runs to the longest common prefix of its first and last key
+    std::size_t size = 1;
+    m_nodes[0].last = static_cast<std::uint32_t>(N);
+    for (std::size_t n = 0; n < size; n++) {
+        node& at = m_nodes[n];
+        const std::string_view low = m_elements[at.first].first;
+        const std::string_view high = m_elements[at.last - 1].first;
+        std::size_t lcp = low.size();
+        if (at.first + 1 != at.last) {
+            lcp = 0;
+            while (lcp < low.size() && lcp < high.size() && low[lcp] == high[lcp]) {
+                lcp++;
+            }
+        }
+        at.length = static_cast<std::uint32_t>(lcp - at.depth);
+        at.terminal = low.size() == lcp;
+        m_first_byte[n] = lcp > at.depth ? static_cast<unsigned char>(low[at.depth]) : 0;
+
+        // the children split the rest of the range by the byte after the label
+        at.child_begin = static_cast<std::uint32_t>(size);
+        for (std::uint32_t begin = at.first + (at.terminal ? 1 : 0); begin < at.last;) {
+            const char c = m_elements[begin].first[lcp];
+            std::uint32_t end = begin + 1;
+            while (end < at.last && m_elements[end].first[lcp] == c) {
+                end++;
+            }
+            node& added = m_nodes[size++];
+            added.first = begin;
+            added.last = end;
+            added.depth = static_cast<std::uint32_t>(lcp);
+            begin = end;
+        }
+        at.child_end = static_cast<std::uint32_t>(size);
+    }
+}
+
+template <typename T, std::size_t N>
+constexpr typename radix_static_tree<T, N>::const_iterator radix_static_tree<T, N>::find(const std::string_view key) const {
+    if constexpr (N == 0) {
+        return end();
+    }
+
+    std::uint32_t n = 0;
+    for (;;) {
+        const node& at = m_nodes[n];
+        if (key.size() - at.depth < at.length || key.substr(at.depth, at.length) != label(at)) {
+            return end();
+        }
+        const std::size_t depth = at.depth + at.length;
+        if (depth == key.size()) {
+            return at.terminal ? begin() + at.first : end();
+        }
+        n = child(at, static_cast<unsigned char>(key[depth]));
+        if (n == 0) {
+            return end();
+        }
+    }
+}
+
+template <typename T, std::size_t N>
+constexpr typename radix_static_tree<T, N>::const_iterator
+radix_static_tree<T, N>::longest_match(const std::string_view key) const {
+    if constexpr (N == 0) {
+        return end();
+    }
+
+    const_iterator found = end();
+    std::uint32_t n = 0;
+    for (;;) {
+        const node& at = m_nodes[n];
+        if (key.size() - at.depth < at.length || key.substr(at.depth, at.length) != label(at)) {
+            return found;
+        }
+        if (at.terminal) {
+            found = begin() + at.first;
+        }
+        const std::size_t depth = at.depth + at.length;
+        if (depth == key.size()) {
+            return found;
+        }
+        n = child(at, static_cast<unsigned char>(key[depth]));
+        if (n == 0) {
+            return found;
+        }
+    }
+}
+
+template <typename T, std::size_t N>
+constexpr std::pair<typename radix_static_tree<T, N>::const_iterator, typename radix_static_tree<T, N>::const_iterator>
+radix_static_tree<T, N>::prefix_range(const std::string_view key) const {
+    if constexpr (N == 0) {
+        return {end(), end()};
+    }
+
+    std::uint32_t n = 0;
+    for (;;) {
+        const node& at = m_nodes[n];
+        // the key ends inside the label: every element below the node begins with it
+        if (key.size() - at.depth <= at.length) {
+            if (label(at).substr(0, key.size() - at.depth) != key.substr(at.depth)) {
+                return {end(), end()};
+            }
+            return {begin() + at.first, begin() + at.last};
+        }
+        if (key.substr(at.depth, at.length) != label(at)) {
+            return {end(), end()};
+        }
+        n = child(at, static_cast<unsigned char>(key[at.depth + at.length]));
+        if (n == 0) {
+            return {end(), end()};
+        }
+    }
+}
+
+template <typename T, std::size_t N>
+void radix_static_tree<T, N>::prefix_match(const std::string_view key, std::vector<const_iterator>& vec) const {
+    vec.clear();
+    const auto [first, last] = prefix_range(key);
+    for (const_iterator it = first; it != last; ++it) {
+        vec.push_back(it);
+    }
+}
+
+// builds a radix_static_tree from a braced list of elements, make_radix_static_tree<int>({{"GET", 1}, ...})
+template <typename T, std::size_t N>
+constexpr radix_static_tree<T, N> make_radix_static_tree(const std::pair<std::string_view, T> (&elements)[N]) {
+    return radix_static_tree<T, N>(std::to_array(elements));
+}
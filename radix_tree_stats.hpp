@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+// structural statistics and an estimate of the heap footprint of a radix_tree.
+// byte counts include the objects themselves, not the bookkeeping of the allocator.
+struct radix_tree_stats {
+    // the last bucket of a histogram collects everything that does not fit
+    static constexpr std::size_t histogram_size = 32;
+
+    std::size_t internal_nodes{};
+    std::size_t leaf_nodes{};
+
+    // internal nodes by number of children, a leaf child included
+    std::array<std::size_t, histogram_size> fanout{};
+    // leaves by number of edges from the root
+    std::array<std::size_t, histogram_size> depth{};
+
+    // total length of all edge labels, in key elements
+    std::size_t edge_label_length{};
+    // edge labels held by the nodes
+    std::size_t edge_label_bytes{};
+    // the copies of the edge labels used as keys of the child maps
+    std::size_t duplicated_key_bytes{};
+    // value_type allocations, including the full key each of them holds
+    std::size_t value_bytes{};
+    // the nodes themselves and the entries of their child maps
+    std::size_t node_bytes{};
+    std::size_t map_entry_bytes{};
+    // slots of the node pool that hold no node, freed or not used yet
+    std::size_t free_node_bytes{};
+    // the hash index, if enabled
+    std::size_t index_bytes{};
+    // the Bloom filter, if enabled
+    std::size_t bloom_bytes{};
+    // the score index, if enabled
+    std::size_t score_index_bytes{};
+    // the rank index, if enabled
+    std::size_t rank_index_bytes{};
+
+    std::size_t heap_bytes{};
+};
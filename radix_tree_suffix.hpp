@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "radix_tree.hpp"
+
+// where a suffix begins: the id of a string and an offset into it
+struct radix_suffix_occurrence {
+    std::uint32_t id;
+    std::uint32_t offset;
+
+    friend bool operator==(const radix_suffix_occurrence&, const radix_suffix_occurrence&) = default;
+};
+
+template <>
+inline std::size_t
+radix_heap_bytes<std::vector<radix_suffix_occurrence>>(const std::vector<radix_suffix_occurrence>& postings) {
+    return postings.capacity() * sizeof(radix_suffix_occurrence);
+}
+
+struct radix_suffix_stats {
+    std::size_t strings{};
+    // one per non-empty suffix of every string
+    std::size_t suffixes{};
+    // suffixes that differ, each a leaf of the tree
+    std::size_t distinct_suffixes{};
+    // the copies of the strings, which the edge labels point into
+    std::size_t text_bytes{};
+    radix_tree_stats tree;
+
+    std::size_t heap_bytes{};
+};
+
+// A generalized suffix tree: every non-empty suffix of every added string is a key of a
+// radix_tree<std::string_view>, whose leaves list the occurrences of the suffix as (string id,
+// offset) pairs. The keys and edge labels point into copies of the strings kept by the index, so no
+// suffix is copied. A substring query is one descent to the node of the pattern, and every leaf below
+// it is an occurrence. The suffixes are sorted before they are inserted, like a suffix array, so
+// each insert is hinted with the previous one and costs only what it does not share with it.
+class radix_suffix_index {
+  public:
+    typedef std::uint32_t string_id;
+    typedef std::vector<radix_suffix_occurrence> postings;
+
+    radix_suffix_index() = default;
+
+    radix_suffix_index(const radix_suffix_index&) = delete;
+    radix_suffix_index& operator=(const radix_suffix_index&) = delete;
+
+    // adds a string and its suffixes, returns its id; ids are given out in order from 0
+    string_id add(std::string_view text) { return add(&text, &text + 1); }
+
+    // adds a range of strings, returns the id of the first. Sorting the suffixes of all of them
+    // together is cheaper than adding them one by one.
+    template <class InputIt>
+    string_id add(InputIt first, InputIt last);
+
+    [[nodiscard]]
+    std::size_t size() const {
+        return m_texts.size();
+    }
+
+    [[nodiscard]]
+    std::string_view text(const string_id id) const {
+        return m_texts.at(id);
+    }
+
+    // Calls visitor(string_id, std::uint32_t offset) for every occurrence of `pattern` in the strings,
+    // in the order of the suffixes that begin there, stopping early when the visitor returns false.
+    // The empty pattern occurs at every offset. Returns the occurrences visited.
+    template <class Visitor>
+    std::size_t for_each_occurrence(std::string_view pattern, Visitor visitor);
+
+    // fills ids with the strings that contain `pattern`, in ascending order
+    void strings_containing(std::string_view pattern, std::vector<string_id>& ids);
+
+    [[nodiscard]]
+    std::size_t count_occurrences(std::string_view pattern) {
+        return for_each_occurrence(pattern, [](string_id, std::uint32_t) {});
+    }
+
+    radix_suffix_stats stats() const;
+
+  private:
+    typedef radix_tree<std::string_view, postings> tree_type;
+
+    // strings are copied into blocks of this size, longer ones get a block of their own
+    static constexpr std::size_t block_size = 64 * 1024;
+
+    tree_type m_tree;
+    std::vector<std::string_view> m_texts;
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    std::size_t m_block_used{block_size};
+    std::size_t m_text_bytes{};
+    std::size_t m_suffixes{};
+
+    std::string_view store(std::string_view text);
+
+    std::string_view suffix(const radix_suffix_occurrence& at) const { return m_texts[at.id].substr(at.offset); }
+};
+
+inline std::string_view radix_suffix_index::store(const std::string_view text) {
+    if (text.empty()) {
+        return {};
+    }
+    if (text.size() > block_size - m_block_used) {
+        m_blocks.push_back(std::make_unique<char[]>(std::max(block_size, text.size())));
+        m_block_used = 0;
+        m_text_bytes += std::max(block_size, text.size());
+    }
+    char* data = m_blocks.back().get() + m_block_used;
+    std::memcpy(data, text.data(), text.size());
+    // a block of its own is full, whatever its size
+    m_block_used = std::min(block_size, m_block_used + text.size());
+    return {data, text.size()};
+}
+
+template <class InputIt>
+radix_suffix_index::string_id radix_suffix_index::add(InputIt first, InputIt last) {
+    const auto id = static_cast<string_id>(m_texts.size());
+
+    std::vector<radix_suffix_occurrence> suffixes;
+    for (; first != last; ++first) {
+        const std::string_view text(*first);
+        if (m_texts.size() >= std::numeric_limits<string_id>::max() ||
+            text.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("radix_suffix_index: too many strings or too long a string");
+        }
+        const auto next = static_cast<string_id>(m_texts.size());
+        m_texts.push_back(store(text));
+        for (std::uint32_t offset = 0; offset < text.size(); offset++) {
+            suffixes.push_back({next, offset});
+        }
+    }
+
+    // equal suffixes end up next to each other, ordered by string and offset
+    std::ranges::sort(suffixes, [this](const radix_suffix_occurrence& a, const radix_suffix_occurrence& b) {
+        if (const int c = suffix(a).compare(suffix(b)); c != 0) {
+            return c < 0;
+        }
+        return a.id != b.id ? a.id < b.id : a.offset < b.offset;
+    });
+
+    tree_type::iterator hint = m_tree.end();
+    for (const radix_suffix_occurrence& at : suffixes) {
+        hint = m_tree.insert(hint, {suffix(at), postings()});
+        hint->second.push_back(at);
+    }
+    m_suffixes += suffixes.size();
+
+    return id;
+}
+
+template <class Visitor>
+std::size_t radix_suffix_index::for_each_occurrence(const std::string_view pattern, Visitor visitor) {
+    std::vector<tree_type::iterator> found;
+    m_tree.prefix_match(pattern, found);
+
+    std::size_t count = 0;
+    for (const tree_type::iterator& it : found) {
+        for (const radix_suffix_occurrence& at : it->second) {
+            count++;
+            if constexpr (std::is_void_v<std::invoke_result_t<Visitor&, string_id, std::uint32_t>>) {
+                visitor(at.id, at.offset);
+            } else if (!visitor(at.id, at.offset)) {
+                return count;
+            }
+        }
+    }
+    return count;
+}
+
+inline void radix_suffix_index::strings_containing(const std::string_view pattern, std::vector<string_id>& ids) {
+    ids.clear();
+    for_each_occurrence(pattern, [&ids](const string_id id, std::uint32_t) { ids.push_back(id); });
+    std::ranges::sort(ids);
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+inline radix_suffix_stats radix_suffix_index::stats() const {
+    radix_suffix_stats st;
+    st.strings = m_texts.size();
+    st.suffixes = m_suffixes;
+    st.distinct_suffixes = m_tree.size();
+    st.text_bytes = m_text_bytes + m_texts.capacity() * sizeof(std::string_view);
+    st.tree = m_tree.stats();
+    st.heap_bytes = st.text_bytes + st.tree.heap_bytes;
+    return st;
+}
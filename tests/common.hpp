@@ -28,3 +28,44 @@ inline map_found_t vec_found_to_map(const vector_found_t& vec) {
     }
     return result;
 }
+
+// a key of up to `max_len` letters from 'a' to `last`
+inline std::string random_key(std::default_random_engine& randeng, const int max_len, const char last) {
+    std::uniform_int_distribution<int> len_dist(0, max_len);
+    std::uniform_int_distribution<int> char_dist('a', last);
+    std::string key;
+    for (int len = len_dist(randeng); len > 0; len--) {
+        key += static_cast<char>(char_dist(randeng));
+    }
+    return key;
+}
+
+// `n` random keys, each put in both containers with the number of its insertion
+template <class Tree>
+void insert_random_keys(Tree& tree, std::map<std::string, int>& expected, std::default_random_engine& randeng,
+                        const int n, const int max_len, const char last) {
+    for (int i = 0; i < n; i++) {
+        const std::string key = random_key(randeng, max_len, last);
+        tree[key] = i;
+        expected[key] = i;
+    }
+}
+
+template <class Tree>
+void insert_unique_keys(Tree& tree, const int value = 1) {
+    for (const auto& key : get_unique_keys()) {
+        tree[key] = value;
+    }
+}
+
+// the keys of `tree` that satisfy `pred`, in key order, by looking at every one of them
+template <class Tree, class Pred>
+std::vector<std::string> keys_where(Tree& tree, Pred pred) {
+    std::vector<std::string> keys;
+    for (const auto& val : tree) {
+        if (pred(val.first)) {
+            keys.push_back(val.first);
+        }
+    }
+    return keys;
+}
@@ -0,0 +1,95 @@
+#include "common.hpp"
+
+TEST(bloom, rejects_misses) {
+    tree_t tree;
+    for (int i = 0; i < 10000; i++) {
+        tree["key/" + std::to_string(i)] = i;
+    }
+
+    tree.enable_bloom_filter(0.01);
+    ASSERT_TRUE(tree.has_bloom_filter());
+    ASSERT_GT(tree.stats().bloom_bytes, 0u);
+
+    for (int i = 0; i < 10000; i++) {
+        auto it = tree.find("key/" + std::to_string(i));
+        ASSERT_NE(tree.end(), it);
+        ASSERT_EQ(i, it->second);
+    }
+    ASSERT_EQ(0u, tree.bloom_stats().rejected);
+    ASSERT_EQ(0u, tree.bloom_stats().false_positives);
+
+    for (int i = 10000; i < 20000; i++) {
+        ASSERT_EQ(tree.end(), tree.find("key/" + std::to_string(i)));
+    }
+    const radix_bloom_stats& st = tree.bloom_stats();
+    ASSERT_EQ(20000u, st.queries);
+    ASSERT_EQ(10000u, st.rejected + st.false_positives);
+    ASSERT_LT(st.false_positive_rate(), 0.03);
+    ASSERT_GT(st.rejection_rate(), 0.45);
+
+    tree.disable_bloom_filter();
+    ASSERT_EQ(0u, tree.stats().bloom_bytes);
+    ASSERT_NE(tree.end(), tree.find("key/1"));
+}
+
+TEST(bloom, same_as_tree_under_churn) {
+    auto randeng = std::default_random_engine();
+    std::uniform_int_distribution<int> len_dist(0, 5);
+    std::uniform_int_distribution<int> char_dist('a', 'd');
+
+    tree_t filtered, plain;
+    filtered.enable_bloom_filter(0.05);
+    filtered.enable_hash_index();
+
+    for (int i = 0; i < 20000; i++) {
+        std::string key(len_dist(randeng), ' ');
+        for (auto& c : key) {
+            c = static_cast<char>(char_dist(randeng));
+        }
+        switch (randeng() % 4) {
+        case 0: ASSERT_EQ(plain.erase(key), filtered.erase(key)) << key; break;
+        case 1:
+            ASSERT_EQ(plain.insert(tree_t::value_type(key, i)).second,
+                      filtered.insert(tree_t::value_type(key, i)).second)
+                << key;
+            break;
+        case 2: filtered[key] = plain[key] = i; break;
+        default: {
+            auto it = filtered.find(key);
+            auto expected = plain.find(key);
+            ASSERT_EQ(expected == plain.end(), it == filtered.end()) << key;
+            if (it != filtered.end()) {
+                ASSERT_EQ(expected->second, it->second);
+            }
+        }
+        }
+        ASSERT_EQ(plain.size(), filtered.size());
+    }
+}
+
+TEST(bloom, rebuilt_on_growth_and_erase) {
+    tree_t tree;
+    tree.enable_bloom_filter();
+    ASSERT_EQ(0u, tree.bloom_stats().rebuilds);
+
+    for (int i = 0; i < 1000; i++) {
+        tree[std::to_string(i)] = i;
+    }
+    const auto rebuilds = tree.bloom_stats().rebuilds;
+    ASSERT_GT(rebuilds, 0u);
+    ASSERT_LT(rebuilds, 10u);
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(tree.erase(std::to_string(i)));
+    }
+    ASSERT_GT(tree.bloom_stats().rebuilds, rebuilds);
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_EQ(tree.end(), tree.find(std::to_string(i)));
+    }
+    // erased keys do not linger in the filter for long
+    ASSERT_GT(tree.bloom_stats().rejection_rate(), 0.5);
+
+    tree["a"] = 1;
+    tree.clear();
+    ASSERT_EQ(tree.end(), tree.find("a"));
+}
@@ -0,0 +1,138 @@
+#include "common.hpp"
+
+#include <cstdint>
+
+#include <radix_tree_burst.hpp>
+
+namespace {
+
+using burst_t = radix_burst_tree<std::string, int>;
+
+void assert_same(burst_t& tree, const std::map<std::string, int>& expected) {
+    ASSERT_EQ(expected.size(), tree.size());
+
+    auto it = tree.begin();
+    for (const auto& [key, value] : expected) {
+        ASSERT_NE(tree.end(), it);
+        ASSERT_EQ(key, it->first);
+        ASSERT_EQ(value, it->second);
+        ++it;
+    }
+    ASSERT_EQ(tree.end(), it);
+}
+
+} // namespace
+
+TEST(burst, small_buckets_against_map) {
+    auto randeng = std::default_random_engine();
+    std::map<std::string, int> expected;
+    // bursts as soon as a bucket holds four keys
+    burst_t tree(4);
+
+    for (int i = 0; i < 5000; i++) {
+        const std::string key = random_key(randeng, 8, 'd');
+        if (randeng() % 3 == 0) {
+            ASSERT_EQ(expected.erase(key) == 1, tree.erase(key)) << key;
+        } else {
+            tree[key] = i;
+            expected[key] = i;
+        }
+
+        const std::string query = random_key(randeng, 8, 'd');
+        const auto found = tree.find(query);
+        if (expected.contains(query)) {
+            ASSERT_NE(tree.end(), found) << query;
+            ASSERT_EQ(query, found->first);
+            ASSERT_EQ(expected[query], found->second);
+        } else {
+            ASSERT_EQ(tree.end(), found) << query;
+        }
+    }
+    assert_same(tree, expected);
+    ASSERT_GT(tree.stats().trie_nodes, 1u);
+
+    for (const auto& [key, value] : expected) {
+        ASSERT_TRUE(tree.erase(key));
+    }
+    ASSERT_EQ(0u, tree.size());
+    ASSERT_EQ(tree.end(), tree.begin());
+    ASSERT_EQ(1u, tree.stats().trie_nodes);
+}
+
+TEST(burst, iterate_from_find) {
+    burst_t tree(2);
+    insert_unique_keys(tree);
+    tree[""] = 0;
+
+    auto it = tree.find("ab");
+    std::vector<std::string> rest;
+    for (; it != tree.end(); ++it) {
+        rest.push_back(it->first);
+    }
+    const std::vector<std::string> expected{"ab", "aba", "abb", "b", "ba", "baa", "bab", "bb", "bba", "bbb"};
+    ASSERT_EQ(expected, rest);
+    ASSERT_EQ("", (*tree.begin()).first);
+}
+
+TEST(burst, insert) {
+    burst_t tree;
+    ASSERT_TRUE(tree.insert({"abc", 1}).second);
+    const auto [it, inserted] = tree.insert({"abc", 2});
+    ASSERT_FALSE(inserted);
+    ASSERT_EQ(1, it->second);
+    it->second = 3;
+    ASSERT_EQ(3, tree["abc"]);
+    ASSERT_EQ(0, tree["abd"]);
+    ASSERT_EQ(2u, tree.size());
+}
+
+TEST(burst, longest_match) {
+    for (const std::size_t threshold : {1u, 2u, 128u}) {
+        burst_t tree(threshold);
+        tree["/"] = 1;
+        tree["/api"] = 2;
+        tree["/api/v2"] = 3;
+        tree["/static"] = 4;
+
+        ASSERT_EQ("/api/v2", tree.longest_match("/api/v2/users")->first);
+        ASSERT_EQ("/api", tree.longest_match("/api/v1")->first);
+        ASSERT_EQ("/", tree.longest_match("/stat")->first);
+        ASSERT_EQ(tree.end(), tree.longest_match("api"));
+    }
+}
+
+TEST(burst, byte_vector_keys) {
+    radix_burst_tree<std::vector<std::uint8_t>, int> tree(3);
+    std::map<std::vector<std::uint8_t>, int> expected;
+    auto randeng = std::default_random_engine();
+    for (int i = 0; i < 2000; i++) {
+        std::vector<std::uint8_t> key(randeng() % 5);
+        for (auto& e : key) {
+            // the high bit set as well, which sorts after the others
+            e = static_cast<std::uint8_t>(randeng() % 4 * 64);
+        }
+        tree[key] = i;
+        expected[key] = i;
+    }
+
+    ASSERT_EQ(expected.size(), tree.size());
+    auto it = tree.begin();
+    for (const auto& [key, value] : expected) {
+        ASSERT_EQ(key, it->first);
+        ASSERT_EQ(value, it->second);
+        ++it;
+    }
+}
+
+TEST(burst, smaller_than_radix_tree) {
+    auto randeng = std::default_random_engine();
+    burst_t burst;
+    tree_t tree;
+    for (int i = 0; i < 20000; i++) {
+        const std::string key = random_key(randeng, 8, 'd') + random_key(randeng, 8, 'd');
+        burst[key] = i;
+        tree[key] = i;
+    }
+    ASSERT_EQ(tree.size(), burst.size());
+    ASSERT_LT(burst.stats().heap_bytes * 4, tree.stats().heap_bytes);
+}
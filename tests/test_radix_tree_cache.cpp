@@ -0,0 +1,85 @@
+#include "common.hpp"
+
+#include <radix_tree_cache.hpp>
+
+using cache_t = radix_lookup_cache<tree_t>;
+
+TEST(cache, hits_and_misses) {
+    tree_t tree;
+    tree["/"] = 1;
+    tree["/api"] = 2;
+    tree["/api/v2"] = 3;
+
+    cache_t cache(tree, 16);
+    for (int i = 0; i < 10; i++) {
+        auto it = cache.longest_match("/api/v2/users");
+        ASSERT_NE(tree.end(), it);
+        ASSERT_EQ("/api/v2", it->first);
+        ASSERT_EQ(tree.find("/api"), cache.find("/api"));
+        ASSERT_EQ(tree.end(), cache.find("/api/v2/users"));
+    }
+    ASSERT_EQ(3u, cache.stats().misses);
+    ASSERT_EQ(27u, cache.stats().hits);
+    ASSERT_DOUBLE_EQ(0.9, cache.stats().hit_rate());
+
+    cache.reset_stats();
+    ASSERT_EQ(0u, cache.stats().hits);
+}
+
+TEST(cache, invalidated_by_insert_and_erase) {
+    tree_t tree;
+    tree["/"] = 1;
+    tree["/api"] = 2;
+
+    cache_t cache(tree, 16);
+    ASSERT_EQ("/api", cache.longest_match("/api/v2/users")->first);
+
+    tree["/api/v2"] = 3;
+    ASSERT_EQ("/api/v2", cache.longest_match("/api/v2/users")->first);
+    ASSERT_EQ(1u, cache.stats().invalidations);
+
+    // changing a value keeps the cache valid and visible through it
+    tree["/api/v2"] = 4;
+    ASSERT_EQ(4, cache.longest_match("/api/v2/users")->second);
+    ASSERT_EQ(1u, cache.stats().invalidations);
+
+    tree.erase("/api/v2");
+    ASSERT_EQ("/api", cache.longest_match("/api/v2/users")->first);
+    tree.clear();
+    ASSERT_EQ(tree.end(), cache.longest_match("/api/v2/users"));
+    ASSERT_EQ(3u, cache.stats().invalidations);
+}
+
+TEST(cache, bounded) {
+    tree_t tree;
+    const std::vector<std::string> unique_keys = get_unique_keys();
+    for (const auto& key : unique_keys) {
+        tree[key] = 1;
+    }
+
+    cache_t cache(tree, 4);
+    auto randeng = std::default_random_engine();
+    for (int i = 0; i < 1000; i++) {
+        const std::string query = unique_keys[randeng() % unique_keys.size()] + "zz";
+        ASSERT_EQ(tree.longest_match(query), cache.longest_match(query)) << query;
+    }
+    ASSERT_GT(cache.stats().misses, 4u);
+}
+
+TEST(cache, outdated_entries) {
+    tree_t tree;
+    cache_t cache(tree, 64);
+    auto randeng = std::default_random_engine();
+    for (int i = 0; i < 5000; i++) {
+        const std::string key = random_key(randeng, 4, 'c');
+        if (i % 10 == 0) {
+            tree.erase(key);
+        } else if (i % 5 == 0) {
+            tree[key] = i;
+        }
+        ASSERT_EQ(tree.longest_match(key), cache.longest_match(key)) << key;
+        ASSERT_EQ(tree.find(key), cache.find(key)) << key;
+    }
+    ASSERT_GT(cache.stats().hits, 0u);
+    ASSERT_GT(cache.stats().invalidations, 0u);
+}
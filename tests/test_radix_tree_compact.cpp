@@ -0,0 +1,175 @@
+#include "common.hpp"
+
+namespace {
+
+using counted_tree_t = radix_tree<std::string, int, std::less<std::string>, radix_tree_counters>;
+
+// inserts and erases random keys in both containers
+template <class Tree>
+void churn(Tree& tree, std::map<std::string, int>& expected, std::default_random_engine& randeng, const int n) {
+    for (int i = 0; i < n; i++) {
+        const std::string key = random_key(randeng, 10, 'e');
+        if (randeng() % 3 == 0) {
+            tree.erase(key);
+            expected.erase(key);
+        } else {
+            tree[key] = i;
+            expected[key] = i;
+        }
+    }
+}
+
+template <class Tree>
+void assert_contents(Tree& tree, const std::map<std::string, int>& expected) {
+    ASSERT_EQ(expected.size(), tree.size());
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), tree.begin(), tree.end()));
+    for (const auto& it : expected) {
+        auto found = tree.find(it.first);
+        ASSERT_NE(tree.end(), found) << it.first;
+        ASSERT_EQ(it.second, found->second);
+    }
+
+    const auto st = tree.stats();
+    const auto c = tree.instrumentation().snapshot();
+    ASSERT_EQ(st.internal_nodes + st.leaf_nodes, c.node_allocs - c.node_frees);
+}
+
+} // namespace
+
+TEST(compact, keeps_the_contents) {
+    auto randeng = std::default_random_engine();
+    std::map<std::string, int> expected;
+    counted_tree_t tree;
+    churn(tree, expected, randeng, 20000);
+    // erase half of what is left, scattered over the pool
+    for (auto it = expected.begin(); it != expected.end() && std::next(it) != expected.end();) {
+        tree.erase(it->first);
+        it = std::next(expected.erase(it));
+    }
+
+    const auto before = tree.stats();
+    tree.compact();
+    assert_contents(tree, expected);
+
+    const auto after = tree.stats();
+    ASSERT_EQ(before.internal_nodes, after.internal_nodes);
+    ASSERT_EQ(before.leaf_nodes, after.leaf_nodes);
+    ASSERT_EQ(before.edge_label_length, after.edge_label_length);
+    // the churn left freed slots behind, the compacted pool is filled in order
+    ASSERT_LT(after.free_node_bytes, before.free_node_bytes);
+    ASSERT_LT(after.free_node_bytes, after.node_bytes);
+
+    churn(tree, expected, randeng, 1000);
+    assert_contents(tree, expected);
+}
+
+TEST(compact, empty_tree) {
+    tree_t tree;
+    tree.compact();
+    ASSERT_TRUE(tree.compact_step(10));
+
+    tree["a"] = 1;
+    tree.erase("a");
+    tree.compact();
+    ASSERT_EQ(tree.end(), tree.find("a"));
+    tree["b"] = 2;
+    ASSERT_EQ(2, tree.find("b")->second);
+}
+
+TEST(compact, steps_between_changes) {
+    auto randeng = std::default_random_engine();
+    std::map<std::string, int> expected;
+    counted_tree_t tree;
+    churn(tree, expected, randeng, 5000);
+
+    int steps = 0;
+    while (!tree.compact_step(50)) {
+        churn(tree, expected, randeng, 10);
+        steps++;
+    }
+    ASSERT_GT(steps, 10);
+    assert_contents(tree, expected);
+
+    // steps without changes in between
+    while (!tree.compact_step(100)) {
+    }
+    assert_contents(tree, expected);
+}
+
+TEST(compact, clear_halfway) {
+    auto randeng = std::default_random_engine();
+    std::map<std::string, int> expected;
+    counted_tree_t tree;
+    churn(tree, expected, randeng, 5000);
+
+    ASSERT_FALSE(tree.compact_step(100));
+    tree.clear();
+    ASSERT_EQ(0u, tree.stats().heap_bytes);
+
+    expected.clear();
+    churn(tree, expected, randeng, 1000);
+    assert_contents(tree, expected);
+}
+
+TEST(compact, with_hash_index_and_cursor) {
+    auto randeng = std::default_random_engine();
+    std::map<std::string, int> expected;
+    counted_tree_t tree;
+    tree.enable_hash_index();
+    churn(tree, expected, randeng, 5000);
+
+    counted_tree_t::cursor cursor(tree);
+    ASSERT_NE(tree.end(), cursor.seek(expected.begin()->first));
+
+    while (!tree.compact_step(64)) {
+        churn(tree, expected, randeng, 5);
+        const auto& key = expected.rbegin()->first;
+        ASSERT_EQ(expected[key], cursor.seek(key)->second);
+    }
+    assert_contents(tree, expected);
+}
+
+TEST(compact, parallel_build_during_a_step) {
+    auto randeng = std::default_random_engine();
+    std::map<std::string, int> expected;
+    counted_tree_t tree;
+    churn(tree, expected, randeng, 5000);
+
+    ASSERT_FALSE(tree.compact_step(100));
+
+    std::vector<counted_tree_t::value_type> values;
+    for (int i = 0; i < 5000; i++) {
+        const std::string key = random_key(randeng, 10, 'e') + "z";
+        values.emplace_back(key, i);
+        expected.emplace(key, i);
+    }
+    tree.build_parallel(values.begin(), values.end(), 4);
+    assert_contents(tree, expected);
+}
+
+TEST(compact, batch_with_hash_index_during_a_step) {
+    auto randeng = std::default_random_engine();
+    std::map<std::string, int> expected;
+    counted_tree_t tree;
+    tree.enable_hash_index();
+    churn(tree, expected, randeng, 5000);
+
+    ASSERT_FALSE(tree.compact_step(1));
+
+    // erasing every key frees leaves the step has not moved yet
+    std::vector<radix_mutation<std::string, int>> batch;
+    for (const auto& it : expected) {
+        batch.push_back({radix_mutation_op::erase, it.first, 0});
+    }
+    for (int i = 0; i < 1000; i++) {
+        const std::string key = random_key(randeng, 10, 'e') + "z";
+        batch.push_back({radix_mutation_op::assign, key, i});
+    }
+    expected.clear();
+    for (std::size_t i = batch.size() - 1000; i < batch.size(); i++) {
+        expected[batch[i].key] = batch[i].value;
+    }
+
+    tree.apply_batch(batch, 2);
+    assert_contents(tree, expected);
+}
@@ -0,0 +1,73 @@
+#include "common.hpp"
+
+#include <thread>
+
+using counted_tree_t = radix_tree<std::string, int, std::less<std::string>, radix_tree_counters>;
+using thread_counted_tree_t = radix_tree<std::string, int, std::less<std::string>, radix_thread_counters>;
+
+TEST(counters, disabled_counters_take_no_space) {
+    static_assert(sizeof(tree_t) < sizeof(counted_tree_t));
+    static_assert(sizeof(tree_t) == sizeof(thread_counted_tree_t));
+}
+
+TEST(counters, allocations_match_the_structure) {
+    auto randeng = std::default_random_engine();
+    std::vector<std::string> unique_keys = get_unique_keys();
+    std::ranges::shuffle(unique_keys, randeng);
+
+    counted_tree_t tree;
+    for (const auto& key : unique_keys) {
+        tree.insert(counted_tree_t::value_type(key, 0));
+        const auto c = tree.instrumentation().snapshot();
+        const auto st = tree.stats();
+        ASSERT_EQ(st.internal_nodes + st.leaf_nodes, c.node_allocs - c.node_frees);
+    }
+    ASSERT_GT(tree.instrumentation().snapshot().edge_splits, 0u);
+
+    for (const auto& key : unique_keys) {
+        tree.erase(key);
+        const auto c = tree.instrumentation().snapshot();
+        const auto st = tree.stats();
+        ASSERT_EQ(st.internal_nodes + st.leaf_nodes, c.node_allocs - c.node_frees);
+    }
+    ASSERT_GT(tree.instrumentation().snapshot().merges, 0u);
+
+    tree["abc"] = 1;
+    tree.clear();
+    const auto c = tree.instrumentation().snapshot();
+    ASSERT_EQ(c.node_allocs, c.node_frees);
+}
+
+TEST(counters, find_costs) {
+    counted_tree_t tree;
+    tree["abcdef"] = 1;
+    tree["abcdege"] = 2;
+    tree["bcdef"] = 3;
+
+    tree.instrumentation().reset();
+    ASSERT_EQ(0u, tree.instrumentation().snapshot().node_visits);
+
+    tree.find("abcdef");
+    const auto c = tree.instrumentation().snapshot();
+    // (root) -> abcde -> f -> $
+    ASSERT_EQ(3u, c.node_visits);
+    ASSERT_GE(c.child_scans, 3u);
+    // std::string keys are compared through views, without copying a part of the key
+    ASSERT_EQ(0u, c.substrs);
+    ASSERT_EQ(0u, c.node_allocs);
+}
+
+TEST(counters, per_thread) {
+    thread_counted_tree_t::instrumentation_type::reset();
+    thread_counted_tree_t tree;
+    tree["abc"] = 1;
+    ASSERT_GT(radix_thread_counters::snapshot().node_allocs, 0u);
+
+    std::thread other([] {
+        ASSERT_EQ(0u, radix_thread_counters::snapshot().node_allocs);
+    });
+    other.join();
+
+    radix_thread_counters::reset();
+    ASSERT_EQ(0u, radix_thread_counters::snapshot().node_allocs);
+}
@@ -0,0 +1,100 @@
+#include "common.hpp"
+
+#include <algorithm>
+
+using counted_tree_t = radix_tree<std::string, int, std::less<>, radix_tree_counters>;
+
+TEST(cursor, seek) {
+    tree_t tree;
+    const std::vector<std::string> unique_keys = get_unique_keys();
+    for (size_t i = 0; i < unique_keys.size(); i++) {
+        tree[unique_keys[i]] = static_cast<int>(i);
+    }
+
+    tree_t::cursor cursor(tree);
+    auto randeng = std::default_random_engine();
+    for (int i = 0; i < 2000; i++) {
+        std::string key = unique_keys[randeng() % unique_keys.size()];
+        if (randeng() % 3 == 0) {
+            key.resize(randeng() % (key.size() + 1));
+            key += static_cast<char>('a' + randeng() % 4);
+        }
+        ASSERT_EQ(tree.find(key), cursor.seek(key)) << key;
+    }
+}
+
+TEST(cursor, seek_empty) {
+    tree_t tree;
+    tree_t::cursor cursor(tree);
+    ASSERT_EQ(tree.end(), cursor.seek("a"));
+    ASSERT_EQ(tree.end(), cursor.seek(""));
+
+    ASSERT_TRUE(cursor.insert(tree_t::value_type("", 1)).second);
+    ASSERT_EQ(1, cursor.seek("")->second);
+}
+
+TEST(cursor, insert_same_as_tree) {
+    auto randeng = std::default_random_engine();
+    std::uniform_int_distribution<int> len_dist(0, 6);
+    std::uniform_int_distribution<int> char_dist('a', 'd');
+
+    tree_t tree, plain;
+    tree_t::cursor cursor(tree);
+
+    for (int i = 0; i < 20000; i++) {
+        std::string key(len_dist(randeng), ' ');
+        for (auto& c : key) {
+            c = static_cast<char>(char_dist(randeng));
+        }
+        switch (randeng() % 4) {
+        case 0: ASSERT_EQ(plain.erase(key), tree.erase(key)) << key; break;
+        case 1: {
+            auto expected = plain.insert(tree_t::value_type(key, i));
+            auto result = cursor.insert(tree_t::value_type(key, i));
+            ASSERT_EQ(expected.second, result.second) << key;
+            ASSERT_EQ(key, result.first->first);
+            ASSERT_EQ(expected.first->second, result.first->second);
+            break;
+        }
+        default: {
+            auto it = cursor.seek(key);
+            ASSERT_EQ(plain.find(key) == plain.end(), it == tree.end()) << key;
+            if (it != tree.end()) {
+                ASSERT_EQ(key, it->first);
+            }
+        }
+        }
+        ASSERT_EQ(plain.size(), tree.size());
+    }
+}
+
+TEST(cursor, sorted_keys_skip_shared_prefix) {
+    std::vector<std::string> keys;
+    for (int i = 0; i < 5000; i++) {
+        keys.push_back("2024-05-17T12:" + std::to_string(100000 + i));
+    }
+
+    counted_tree_t from_root;
+    for (const auto& key : keys) {
+        from_root.insert(counted_tree_t::value_type(key, 1));
+    }
+
+    counted_tree_t with_cursor;
+    counted_tree_t::cursor cursor(with_cursor);
+    for (const auto& key : keys) {
+        ASSERT_TRUE(cursor.insert(counted_tree_t::value_type(key, 1)).second);
+    }
+    ASSERT_EQ(from_root.size(), with_cursor.size());
+    ASSERT_TRUE(std::equal(from_root.begin(), from_root.end(), with_cursor.begin(), with_cursor.end()));
+    ASSERT_LT(with_cursor.instrumentation().snapshot().node_visits,
+              from_root.instrumentation().snapshot().node_visits / 2);
+
+    from_root.instrumentation().reset();
+    with_cursor.instrumentation().reset();
+    for (const auto& key : keys) {
+        ASSERT_NE(from_root.end(), from_root.find(key));
+        ASSERT_NE(with_cursor.end(), cursor.seek(key));
+    }
+    ASSERT_LT(with_cursor.instrumentation().snapshot().node_visits,
+              from_root.instrumentation().snapshot().node_visits / 2);
+}
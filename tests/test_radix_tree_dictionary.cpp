@@ -0,0 +1,209 @@
+#include "common.hpp"
+
+#include <radix_tree_dictionary.hpp>
+
+namespace {
+
+using counted_tree_t = radix_tree<std::string, int, std::less<std::string>, radix_tree_counters>;
+
+template <class Tree>
+void assert_ranks(Tree& tree, const std::set<std::string>& expected, std::default_random_engine& randeng) {
+    std::size_t pos = 0;
+    for (const auto& key : expected) {
+        ASSERT_EQ(pos, tree.rank(key)) << key;
+        ASSERT_EQ(key, tree.select(pos)->first);
+        pos++;
+    }
+    ASSERT_TRUE(tree.select(expected.size()) == tree.end());
+
+    for (int i = 0; i < 100; i++) {
+        const std::string key = random_key(randeng, 8, 'd') + (i % 2 == 0 ? "e" : "");
+        const auto bound = static_cast<std::size_t>(std::distance(expected.begin(), expected.lower_bound(key)));
+        ASSERT_EQ(bound, tree.rank(key)) << key;
+    }
+}
+
+} // namespace
+
+TEST(rank_index, against_std_set) {
+    auto randeng = std::default_random_engine();
+    std::set<std::string> expected;
+    tree_t tree;
+    tree.enable_rank_index();
+    ASSERT_TRUE(tree.has_rank_index());
+    ASSERT_EQ(0u, tree.rank("a"));
+    ASSERT_TRUE(tree.select(0) == tree.end());
+
+    for (int i = 0; i < 3000; i++) {
+        const std::string key = random_key(randeng, 8, 'd');
+        tree[key] = i;
+        expected.insert(key);
+    }
+    assert_ranks(tree, expected, randeng);
+
+    // kept up to date under churn and compaction
+    for (int i = 0; i < 5000; i++) {
+        const std::string key = random_key(randeng, 8, 'd');
+        if (i % 2 == 0) {
+            tree.erase(key);
+            expected.erase(key);
+        } else {
+            tree.insert({key, i});
+            expected.insert(key);
+        }
+        if (i % 1000 == 0) {
+            tree.compact_step(300);
+        }
+    }
+    assert_ranks(tree, expected, randeng);
+    ASSERT_GT(tree.stats().rank_index_bytes, 0u);
+
+    tree.clear();
+    tree["x"] = 1;
+    ASSERT_EQ(1u, tree.rank("y"));
+    ASSERT_EQ("x", tree.select(0)->first);
+}
+
+TEST(rank_index, parallel_operations_and_enabled_later) {
+    auto randeng = std::default_random_engine();
+    std::set<std::string> expected;
+    std::vector<tree_t::value_type> values;
+    for (int i = 0; i < 10000; i++) {
+        const std::string key = random_key(randeng, 10, 'd');
+        if (expected.insert(key).second) {
+            values.emplace_back(key, i);
+        }
+    }
+
+    tree_t tree;
+    tree.enable_rank_index();
+    tree.build_parallel(values.begin(), values.end(), 4);
+    assert_ranks(tree, expected, randeng);
+
+    std::vector<radix_mutation<std::string, int>> batch;
+    for (int i = 0; i < 3000; i++) {
+        const std::string key = random_key(randeng, 10, 'd');
+        if (i % 3 == 0) {
+            batch.push_back({radix_mutation_op::erase, key});
+            expected.erase(key);
+        } else {
+            batch.push_back({radix_mutation_op::assign, key, i});
+            expected.insert(key);
+        }
+    }
+    tree.apply_batch(batch, 4);
+    assert_ranks(tree, expected, randeng);
+
+    tree.disable_rank_index();
+    ASSERT_FALSE(tree.has_rank_index());
+    tree.erase(*expected.begin());
+    expected.erase(expected.begin());
+    tree.enable_rank_index();
+    assert_ranks(tree, expected, randeng);
+}
+
+TEST(rank_index, one_descent) {
+    auto randeng = std::default_random_engine();
+    counted_tree_t tree;
+    tree.enable_rank_index();
+    for (int i = 0; i < 20000; i++) {
+        tree[random_key(randeng, 12, 'd')] = i;
+    }
+
+    tree.instrumentation().reset();
+    const std::size_t pos = tree.rank("bcdabcda");
+    const auto it = tree.select(tree.size() / 2);
+    ASSERT_GT(pos, 0u);
+    ASSERT_TRUE(it != tree.end());
+    ASSERT_LE(tree.instrumentation().snapshot().node_visits, 2u * 14);
+}
+
+TEST(rank_index, bytes_above_0x7f) {
+    tree_t tree;
+    std::set<std::string> expected;
+    for (const char* key : {"a", "ab", "a\xe9", "z", "\xc3\xa9", "\xc3\xa9t\xc3\xa9"}) {
+        tree[key] = 1;
+        expected.insert(key);
+    }
+    // nothing to count with before the index is enabled
+    ASSERT_EQ(0u, tree.rank("z"));
+    ASSERT_TRUE(tree.select(0) == tree.end());
+
+    tree.enable_rank_index();
+    std::size_t pos = 0;
+    for (const auto& key : expected) {
+        ASSERT_EQ(pos++, tree.rank(key)) << key;
+    }
+    for (const std::string key : {"a\x80", "a\xff", "{", "\xc3\xa9s", "\xff"}) {
+        const auto bound = static_cast<std::size_t>(std::distance(expected.begin(), expected.lower_bound(key)));
+        ASSERT_EQ(bound, tree.rank(key)) << key;
+    }
+}
+
+TEST(radix_dictionary, ids_in_key_order) {
+    const std::vector<std::string> keys{"", "a", "ab", "abc", "abd", "b", "ba", "zzz"};
+    const radix_dictionary<std::string> dict(keys.begin(), keys.end());
+    ASSERT_EQ(keys.size(), dict.size());
+
+    for (std::uint32_t id = 0; id < keys.size(); id++) {
+        ASSERT_EQ(id, dict.find(keys[id])) << keys[id];
+        ASSERT_EQ(keys[id], dict.key(id));
+        ASSERT_EQ(id, dict.lower_bound(keys[id]));
+    }
+    ASSERT_FALSE(dict.find("abe").has_value());
+    ASSERT_FALSE(dict.find("zz").has_value());
+    ASSERT_FALSE(dict.find("c").has_value());
+    ASSERT_EQ(5u, dict.lower_bound("abe"));
+    ASSERT_EQ(7u, dict.lower_bound("c"));
+    ASSERT_EQ(8u, dict.lower_bound("zzzz"));
+    ASSERT_EQ(3u, dict.lower_bound("abb"));
+    ASSERT_THROW(dict.key(8), std::out_of_range);
+
+    const std::vector<std::string> unsorted{"b", "a"};
+    ASSERT_THROW(radix_dictionary<std::string>(unsorted.begin(), unsorted.end()), std::invalid_argument);
+    const std::vector<std::string> duplicates{"a", "a"};
+    ASSERT_THROW(radix_dictionary<std::string>(duplicates.begin(), duplicates.end()), std::invalid_argument);
+
+    const radix_dictionary<std::string> empty;
+    ASSERT_FALSE(empty.find("").has_value());
+    ASSERT_EQ(0u, empty.lower_bound("a"));
+}
+
+TEST(radix_dictionary, frozen_from_a_tree) {
+    auto randeng = std::default_random_engine();
+    tree_t tree;
+    tree.enable_rank_index();
+    std::size_t key_bytes = 0;
+    for (int i = 0; i < 5000; i++) {
+        tree[random_key(randeng, 12, 'd')] = i;
+    }
+    std::vector<std::string_view> keys;
+    for (const auto& [key, value] : tree) {
+        keys.push_back(key);
+        key_bytes += key.size();
+    }
+
+    const radix_dictionary<std::string> dict(keys.begin(), keys.end());
+    ASSERT_EQ(tree.size(), dict.size());
+    for (int i = 0; i < 2000; i++) {
+        const std::string key = random_key(randeng, 13, 'd');
+        const auto it = tree.find(key);
+        ASSERT_EQ(it != tree.end(), dict.find(key).has_value()) << key;
+        ASSERT_EQ(tree.rank(key), dict.lower_bound(key)) << key;
+    }
+    for (std::uint32_t id = 0; id < dict.size(); id++) {
+        ASSERT_EQ(tree.select(id)->first, dict.key(id));
+    }
+    // smaller than a vector of the keys alone, let alone one with a hash map from the keys to ids
+    ASSERT_LT(dict.memory_bytes(), key_bytes + dict.size() * sizeof(std::string));
+}
+
+TEST(radix_dictionary, byte_vector_keys) {
+    const std::vector<std::vector<std::uint8_t>> keys{{0x00}, {0x00, 0xff}, {0x7f}, {0x80, 0x01}, {0xff}};
+    const radix_dictionary<std::vector<std::uint8_t>> dict(keys.begin(), keys.end());
+    for (std::uint32_t id = 0; id < keys.size(); id++) {
+        ASSERT_EQ(id, dict.find(keys[id]));
+        ASSERT_EQ(keys[id], dict.key(id));
+    }
+    ASSERT_EQ(3u, dict.lower_bound({0x80}));
+}
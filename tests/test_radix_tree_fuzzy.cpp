@@ -0,0 +1,126 @@
+#include "common.hpp"
+
+namespace {
+
+using counted_tree_t = radix_tree<std::string, int, std::less<std::string>, radix_tree_counters>;
+
+int levenshtein(const std::string& a, const std::string& b) {
+    std::vector<int> row(b.size() + 1);
+    for (std::size_t j = 0; j <= b.size(); j++) {
+        row[j] = static_cast<int>(j);
+    }
+    for (std::size_t i = 1; i <= a.size(); i++) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for (std::size_t j = 1; j <= b.size(); j++) {
+            const int above = row[j];
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+std::map<std::string, int> fuzzy_found(tree_t& tree, const std::string& key, const int max_distance) {
+    std::map<std::string, int> found;
+    std::string last;
+    tree.fuzzy_match(key, max_distance, [&](tree_t::value_type& val, const int distance) {
+        // in key order
+        EXPECT_TRUE(found.empty() || last < val.first);
+        last = val.first;
+        found.emplace(val.first, distance);
+    });
+    return found;
+}
+
+} // namespace
+
+TEST(fuzzy_match, against_brute_force) {
+    auto randeng = std::default_random_engine();
+    tree_t tree;
+    for (int i = 0; i < 3000; i++) {
+        tree[random_key(randeng, 8, 'd')] = i;
+    }
+
+    for (int i = 0; i < 200; i++) {
+        const std::string query = random_key(randeng, 8, 'e');
+        for (int max_distance = 0; max_distance <= 3; max_distance++) {
+            std::map<std::string, int> expected;
+            for (const auto& [key, value] : tree) {
+                if (const int distance = levenshtein(query, key); distance <= max_distance) {
+                    expected.emplace(key, distance);
+                }
+            }
+            ASSERT_EQ(expected, fuzzy_found(tree, query, max_distance)) << query << " " << max_distance;
+        }
+    }
+}
+
+TEST(fuzzy_match, small_tree) {
+    tree_t tree;
+    insert_unique_keys(tree);
+    tree[""] = 0;
+
+    const std::map<std::string, int> exact{{"ab", 0}};
+    ASSERT_EQ(exact, fuzzy_found(tree, "ab", 0));
+
+    const std::map<std::string, int> expected{{"a", 1},  {"aa", 1}, {"aab", 1}, {"ab", 0}, {"aba", 1},
+                                              {"abb", 1}, {"b", 1},  {"bab", 1}, {"bb", 1}};
+    ASSERT_EQ(expected, fuzzy_found(tree, "ab", 1));
+    ASSERT_EQ(tree.size(), fuzzy_found(tree, "ab", 2).size());
+
+    ASSERT_TRUE(fuzzy_found(tree, "xyzw", 1).empty());
+    ASSERT_TRUE(fuzzy_found(tree, "ab", -1).empty());
+
+    tree_t empty;
+    ASSERT_EQ(0u, empty.fuzzy_match("a", 3, [](tree_t::value_type&, int) { ADD_FAILURE(); }));
+}
+
+TEST(fuzzy_match, stops_early) {
+    tree_t tree;
+    insert_unique_keys(tree);
+
+    std::vector<std::string> seen;
+    const std::size_t n = tree.fuzzy_match("ab", 1, [&](tree_t::value_type& val, int) {
+        seen.push_back(val.first);
+        return seen.size() < 3;
+    });
+    ASSERT_EQ(3u, n);
+    const std::vector<std::string> first{"a", "aa", "aab"};
+    ASSERT_EQ(first, seen);
+
+    seen.clear();
+    ASSERT_EQ(2u, tree.fuzzy_match("ab", 1, [&](tree_t::value_type& val, int) { seen.push_back(val.first); }, 2));
+    ASSERT_EQ(2u, seen.size());
+
+    // the visitor may change the values
+    ASSERT_EQ(9u, tree.fuzzy_match("ab", 1, [](tree_t::value_type& val, int) { val.second = 7; }));
+    ASSERT_EQ(7, tree["aba"]);
+    ASSERT_EQ(1, tree["bbb"]);
+}
+
+TEST(fuzzy_match, visits_few_nodes) {
+    // words made of syllables share prefixes the way a real dictionary does
+    const std::vector<std::string> syllables{"ka", "ro", "mit", "sel", "ban", "tu",  "qui", "der", "ol", "vex",
+                                             "pa", "zen", "lum", "chi", "ast", "nor", "ep", "fi",  "gra", "hul"};
+    auto randeng = std::default_random_engine();
+    counted_tree_t tree;
+    for (int i = 0; i < 50000; i++) {
+        std::string key;
+        for (int n = 2 + static_cast<int>(randeng() % 3); n > 0; n--) {
+            key += syllables[randeng() % syllables.size()];
+        }
+        tree[key] = i;
+    }
+    const auto st = tree.stats();
+
+    const std::vector<std::string> queries{"karomitsel", "banturo", "quidersel", "xyzxyzab"};
+    tree.instrumentation().reset();
+    std::size_t found = 0;
+    for (const auto& query : queries) {
+        found += tree.fuzzy_match(query, 2, [](counted_tree_t::value_type&, int) {});
+    }
+    ASSERT_GT(found, 0u);
+    // less than 5% of the internal nodes per query
+    ASSERT_LT(tree.instrumentation().snapshot().node_visits * 20, queries.size() * st.internal_nodes);
+}
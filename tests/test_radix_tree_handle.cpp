@@ -0,0 +1,172 @@
+#include "common.hpp"
+
+#include <cstdint>
+
+#include <radix_tree_handle.hpp>
+
+namespace {
+
+using handle_tree_t = radix_handle_tree<std::string, int>;
+
+void assert_same(handle_tree_t& tree, const std::map<std::string, int>& expected) {
+    ASSERT_EQ(expected.size(), tree.size());
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), tree.begin(), tree.end()));
+}
+
+} // namespace
+
+TEST(handle_tree, half_the_node_size) {
+    ASSERT_LE(2 * handle_tree_t::node_size(), sizeof(radix_tree_node<std::string, int, std::less<std::string>>));
+}
+
+TEST(handle_tree, against_map) {
+    auto randeng = std::default_random_engine();
+    std::map<std::string, int> expected;
+    handle_tree_t tree;
+
+    for (int i = 0; i < 20000; i++) {
+        const std::string key = random_key(randeng, 8, 'd');
+        if (randeng() % 3 == 0) {
+            ASSERT_EQ(expected.erase(key) == 1, tree.erase(key)) << key;
+        } else {
+            tree[key] = i;
+            expected[key] = i;
+        }
+
+        const std::string query = random_key(randeng, 8, 'd');
+        const auto found = tree.find(query);
+        if (expected.contains(query)) {
+            ASSERT_NE(tree.end(), found) << query;
+            ASSERT_EQ(query, found->first);
+            ASSERT_EQ(expected[query], found->second);
+        } else {
+            ASSERT_EQ(tree.end(), found) << query;
+        }
+    }
+    assert_same(tree, expected);
+
+    for (int i = 0; i < 500; i++) {
+        const std::string key = random_key(randeng, 10, 'e');
+
+        const auto longest = tree.longest_match(key);
+        const auto prefixes = keys_where(tree, [&](const std::string& k) { return key.starts_with(k); });
+        ASSERT_EQ(prefixes.empty(), longest == tree.end()) << key;
+        if (!prefixes.empty()) {
+            ASSERT_EQ(prefixes.back(), longest->first);
+        }
+
+        std::vector<handle_tree_t::iterator> vec;
+        tree.prefix_match(key.substr(0, key.size() / 2), vec);
+        std::vector<std::string> found;
+        for (const auto& it : vec) {
+            found.push_back(it->first);
+        }
+        ASSERT_EQ(keys_where(tree, [&](const std::string& k) { return k.starts_with(key.substr(0, key.size() / 2)); }),
+                  found);
+    }
+
+    // erasing everything merges the nodes back down to the root
+    for (const auto& [key, value] : expected) {
+        ASSERT_TRUE(tree.erase(key));
+    }
+    ASSERT_EQ(0u, tree.size());
+    ASSERT_EQ(tree.end(), tree.begin());
+    ASSERT_EQ(1u, tree.stats().nodes);
+}
+
+TEST(handle_tree, path_compression) {
+    handle_tree_t tree;
+    insert_unique_keys(tree);
+    tree["abcdef"] = 2;
+    tree[""] = 0;
+
+    ASSERT_EQ(get_unique_keys().size() + 2, tree.size());
+    ASSERT_EQ(0, tree.find("")->second);
+    ASSERT_EQ(2, tree.find("abcdef")->second);
+    ASSERT_EQ(tree.end(), tree.find("abcde"));
+    ASSERT_EQ("ab", tree.longest_match("abcde")->first);
+    ASSERT_FALSE(tree.insert({"abcdef", 3}).second);
+    ASSERT_EQ(2, tree.find("abcdef")->second);
+
+    // iterators stay valid over inserts that split the edges above them
+    const auto it = tree.find("abcdef");
+    tree["abcd"] = 4;
+    tree["abcdex"] = 5;
+    ASSERT_EQ("abcdef", it->first);
+    ASSERT_EQ("abcdex", std::next(it)->first);
+
+    ASSERT_TRUE(tree.erase("abcd"));
+    ASSERT_TRUE(tree.erase("abcdex"));
+    ASSERT_FALSE(tree.erase("abcd"));
+    ASSERT_EQ(2, tree["abcdef"]);
+    // the root, one node per unique key and one for the long key
+    ASSERT_EQ(1 + get_unique_keys().size() + 1, tree.stats().nodes);
+
+    tree.clear();
+    ASSERT_TRUE(tree.empty());
+    ASSERT_EQ(tree.end(), tree.begin());
+    tree["x"] = 1;
+    ASSERT_EQ(1, tree.begin()->second);
+}
+
+TEST(handle_tree, unsigned_byte_order) {
+    std::vector<std::string> keys{"\xff", "\x7f", "\x80\x01", "a", std::string("\xff\x00", 2), std::string(1, '\0')};
+    handle_tree_t tree;
+    for (const auto& key : keys) {
+        tree[key] = 1;
+    }
+
+    // the order of std::less<std::string>, which compares the chars as unsigned
+    std::ranges::sort(keys);
+    std::vector<std::string> found;
+    for (const auto& [key, value] : tree) {
+        found.push_back(key);
+    }
+    ASSERT_EQ(keys, found);
+}
+
+TEST(handle_tree, smaller_than_radix_tree) {
+    auto randeng = std::default_random_engine();
+    handle_tree_t tree;
+    tree_t reference;
+    for (int i = 0; i < 50000; i++) {
+        const std::string key = random_key(randeng, 12, 'z');
+        tree[key] = i;
+        reference[key] = i;
+    }
+
+    const radix_handle_stats st = tree.stats();
+    ASSERT_EQ(st.nodes * handle_tree_t::node_size(), st.node_bytes);
+    ASSERT_LT(2 * st.heap_bytes, reference.stats().heap_bytes);
+}
+
+TEST(handle_pool, handles_across_chunks) {
+    radix_handle_pool<std::uint64_t> pool;
+    std::vector<radix_handle_pool<std::uint64_t>::handle> handles;
+    for (std::uint64_t i = 0; i < 20000; i++) {
+        handles.push_back(pool.create(i));
+    }
+    for (std::uint64_t i = 0; i < handles.size(); i++) {
+        ASSERT_EQ(i, handles[i]);
+        ASSERT_EQ(i, pool[handles[i]]);
+    }
+
+    const std::size_t bytes = pool.memory_bytes();
+    for (std::size_t i = 0; i < handles.size(); i += 2) {
+        pool.destroy(handles[i]);
+    }
+    for (std::size_t i = 0; i < handles.size(); i += 2) {
+        handles[i] = pool.create(std::uint64_t{7});
+    }
+    ASSERT_EQ(bytes, pool.memory_bytes());
+    ASSERT_EQ(handles.size(), pool.live());
+    ASSERT_EQ(7u, pool[handles[0]]);
+    ASSERT_EQ(1u, pool[handles[1]]);
+    ASSERT_EQ(19999u, pool[handles.back()]);
+
+    for (const auto h : handles) {
+        pool.destroy(h);
+    }
+    pool.release();
+    ASSERT_EQ(0u, pool.memory_bytes());
+}
@@ -0,0 +1,75 @@
+#include "common.hpp"
+
+TEST(hash_index, enable_on_filled_tree) {
+    tree_t tree;
+    const std::vector<std::string> unique_keys = get_unique_keys();
+    for (size_t i = 0; i < unique_keys.size(); i++) {
+        tree[unique_keys[i]] = static_cast<int>(i);
+    }
+
+    ASSERT_FALSE(tree.has_hash_index());
+    tree.enable_hash_index();
+    ASSERT_TRUE(tree.has_hash_index());
+
+    for (size_t i = 0; i < unique_keys.size(); i++) {
+        auto it = tree.find(unique_keys[i]);
+        ASSERT_NE(tree.end(), it);
+        ASSERT_EQ(unique_keys[i], it->first);
+        ASSERT_EQ(static_cast<int>(i), it->second);
+    }
+    ASSERT_EQ(tree.end(), tree.find("c"));
+    ASSERT_EQ(tree.end(), tree.find(""));
+    ASSERT_GT(tree.stats().index_bytes, 0u);
+
+    tree.disable_hash_index();
+    ASSERT_EQ(0u, tree.stats().index_bytes);
+    ASSERT_NE(tree.end(), tree.find("aba"));
+}
+
+TEST(hash_index, same_as_tree_under_churn) {
+    auto randeng = std::default_random_engine();
+    std::uniform_int_distribution<int> len_dist(0, 5);
+    std::uniform_int_distribution<int> char_dist('a', 'd');
+
+    tree_t indexed, plain;
+    indexed.enable_hash_index();
+
+    for (int i = 0; i < 20000; i++) {
+        std::string key(len_dist(randeng), ' ');
+        for (auto& c : key) {
+            c = static_cast<char>(char_dist(randeng));
+        }
+        switch (randeng() % 4) {
+        case 0: ASSERT_EQ(plain.erase(key), indexed.erase(key)) << key; break;
+        case 1:
+            ASSERT_EQ(plain.insert(tree_t::value_type(key, i)).second,
+                      indexed.insert(tree_t::value_type(key, i)).second)
+                << key;
+            break;
+        case 2: indexed[key] = plain[key] = i; break;
+        default: {
+            auto it = indexed.find(key);
+            auto expected = plain.find(key);
+            ASSERT_EQ(expected == plain.end(), it == indexed.end()) << key;
+            if (it != indexed.end()) {
+                ASSERT_EQ(key, it->first);
+                ASSERT_EQ(expected->second, it->second);
+            }
+        }
+        }
+        ASSERT_EQ(plain.size(), indexed.size());
+    }
+}
+
+TEST(hash_index, clear) {
+    tree_t tree;
+    tree.enable_hash_index();
+    tree["abc"] = 1;
+    tree["abd"] = 2;
+    tree.clear();
+    ASSERT_EQ(tree.end(), tree.find("abc"));
+    tree["abc"] = 3;
+    ASSERT_EQ(3, tree.find("abc")->second);
+    ASSERT_TRUE(tree.erase("abc"));
+    ASSERT_FALSE(tree.erase("abc"));
+}
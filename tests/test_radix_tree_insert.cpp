@@ -111,3 +111,64 @@ TEST(insert, after_erase) {
         ASSERT_TRUE(snd);
     }
 }
+
+TEST(insert, range) {
+    auto randeng = std::default_random_engine();
+    std::vector<std::string> unique_keys = get_unique_keys();
+    unique_keys.push_back("");
+    unique_keys.push_back("aaaaaa");
+    unique_keys.push_back("abababab");
+    for (size_t i = 0; i < unique_keys.size(); i++) {
+        std::vector<std::pair<std::string, int>> values;
+        for (const auto& key : unique_keys) {
+            values.emplace_back(key, randeng() % 100);
+        }
+        if (i == 0) {
+            std::ranges::sort(values);
+        } else {
+            std::ranges::shuffle(values, randeng);
+        }
+        // duplicates keep the first value, as with single inserts
+        values.push_back(values.front());
+        values.back().second = -1;
+
+        tree_t tree;
+        tree["bab"] = 7;
+        tree.insert(values.begin(), values.end());
+
+        map_found_t expected(values.begin(), values.end());
+        expected["bab"] = 7;
+        ASSERT_EQ(expected.size(), tree.size());
+        map_found_t result;
+        for (auto it = tree.begin(); it != tree.end(); ++it) {
+            result.emplace(it->first, it->second);
+        }
+        ASSERT_EQ(expected, result);
+        for (const auto& [key, value] : expected) {
+            ASSERT_NE(tree.end(), tree.find(key)) << key;
+        }
+    }
+}
+
+TEST(insert, hint) {
+    tree_t tree;
+    auto hint = tree.insert(tree.end(), tree_t::value_type("abc", 1));
+    ASSERT_EQ("abc", hint->first);
+
+    hint = tree.insert(hint, tree_t::value_type("abd", 2));
+    ASSERT_EQ("abd", hint->first);
+    hint = tree.insert(hint, tree_t::value_type("b", 3));
+    ASSERT_EQ("b", hint->first);
+    hint = tree.insert(hint, tree_t::value_type("", 4));
+    ASSERT_EQ("", hint->first);
+
+    // an existing key is not overwritten
+    hint = tree.insert(tree.find("abc"), tree_t::value_type("abd", 5));
+    ASSERT_EQ("abd", hint->first);
+    ASSERT_EQ(2, hint->second);
+
+    ASSERT_EQ(4u, tree.size());
+    ASSERT_EQ(1, tree["abc"]);
+    ASSERT_EQ(3, tree["b"]);
+    ASSERT_EQ(4, tree[""]);
+}
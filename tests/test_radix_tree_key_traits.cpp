@@ -0,0 +1,106 @@
+#include "common.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace {
+
+// runs the same random workload on `tree` and on a std::map, checking after every step
+template <typename Tree, typename MakeKey>
+void check_against_map(Tree& tree, MakeKey make_key) {
+    std::map<std::string, int> expected;
+    auto randeng = std::default_random_engine();
+    const std::vector<std::string> unique_keys = get_unique_keys();
+
+    for (int i = 0; i < 500; i++) {
+        const std::string& key = unique_keys[randeng() % unique_keys.size()];
+        if (randeng() % 3 == 0) {
+            ASSERT_EQ(expected.erase(key) == 1, tree.erase(make_key(key))) << key;
+        } else {
+            tree[make_key(key)] = i;
+            expected[key] = i;
+        }
+        ASSERT_EQ(expected.size(), tree.size());
+
+        const std::string& query = unique_keys[randeng() % unique_keys.size()];
+        const auto found = tree.find(make_key(query));
+        if (expected.contains(query)) {
+            ASSERT_NE(tree.end(), found) << query;
+            ASSERT_EQ(expected[query], found->second);
+        } else {
+            ASSERT_EQ(tree.end(), found) << query;
+        }
+    }
+
+    std::vector<int> values;
+    for (const auto& it : tree) {
+        values.push_back(it.second);
+    }
+    std::vector<int> expected_values;
+    for (const auto& it : expected) {
+        expected_values.push_back(it.second);
+    }
+    ASSERT_EQ(expected_values, values);
+}
+
+std::vector<std::uint8_t> bytes_of(const std::string& s) {
+    return {s.begin(), s.end()};
+}
+
+} // namespace
+
+TEST(key_traits, string_views) {
+    static_assert(radix_key_traits_for<radix_key_traits<std::string>, std::string>);
+
+    using traits = radix_key_traits<std::string>;
+    const std::string key = "abcdef";
+    const std::string_view slice = traits::slice(traits::view(key), 2, 3);
+    ASSERT_EQ("cde", slice);
+    ASSERT_EQ(key.data() + 2, slice.data());
+    ASSERT_EQ("f", traits::slice(traits::view(key), 5, 10));
+    ASSERT_EQ(3, traits::common_prefix(traits::view(key), "abcx"));
+}
+
+TEST(key_traits, byte_vector) {
+    radix_tree<std::vector<std::uint8_t>, int> tree;
+    check_against_map(tree, bytes_of);
+
+    tree.clear();
+    tree[bytes_of("/api")] = 1;
+    tree[bytes_of("/api/v2")] = 2;
+    tree[bytes_of("/static")] = 3;
+
+    ASSERT_EQ(2, tree.longest_match(bytes_of("/api/v2/users"))->second);
+    ASSERT_EQ(1, tree.longest_match(bytes_of("/api/v1"))->second);
+    ASSERT_EQ(tree.end(), tree.longest_match(bytes_of("/other")));
+
+    std::vector<decltype(tree)::iterator> found;
+    tree.prefix_match(bytes_of("/ap"), found);
+    ASSERT_EQ(2u, found.size());
+}
+
+TEST(key_traits, string_view_keys) {
+    // the tree refers to these strings, they have to outlive it
+    const std::vector<std::string> storage = get_unique_keys();
+
+    radix_tree<std::string_view, int> tree;
+    check_against_map(tree, [&](const std::string& key) {
+        return std::string_view(*std::ranges::find(storage, key));
+    });
+}
+
+TEST(key_traits, byte_span_keys) {
+    std::vector<std::vector<std::byte>> storage;
+    for (const std::string& key : get_unique_keys()) {
+        storage.emplace_back(reinterpret_cast<const std::byte*>(key.data()),
+                             reinterpret_cast<const std::byte*>(key.data() + key.size()));
+    }
+    const std::vector<std::string> unique_keys = get_unique_keys();
+
+    radix_tree<std::span<const std::byte>, int, radix_span_less> tree;
+    check_against_map(tree, [&](const std::string& key) {
+        return std::span<const std::byte>(storage[std::ranges::find(unique_keys, key) - unique_keys.begin()]);
+    });
+}
@@ -0,0 +1,126 @@
+#include "common.hpp"
+
+namespace {
+
+using matcher_t = radix_matcher<std::string, int>;
+using occurrence = std::pair<std::uint64_t, std::string>;
+
+// every occurrence of every non-empty key, by the end of the occurrence and then longest first
+std::vector<occurrence> occurrences(const std::map<std::string, int>& keys, const std::string& text) {
+    std::size_t max_len = 0;
+    for (const auto& [key, value] : keys) {
+        max_len = std::max(max_len, key.size());
+    }
+
+    std::vector<occurrence> found;
+    for (std::size_t end = 1; end <= text.size(); end++) {
+        for (std::size_t begin = end - std::min(end, max_len); begin < end; begin++) {
+            if (keys.contains(text.substr(begin, end - begin))) {
+                found.emplace_back(begin, text.substr(begin, end - begin));
+            }
+        }
+    }
+    return found;
+}
+
+std::vector<occurrence> scanned(const matcher_t& matcher, const std::string& text) {
+    std::vector<occurrence> found;
+    const std::size_t n =
+        matcher.scan(text, [&](std::uint64_t begin, tree_t::value_type& val) { found.emplace_back(begin, val.first); });
+    EXPECT_EQ(found.size(), n);
+    return found;
+}
+
+} // namespace
+
+TEST(matcher, classic_example) {
+    tree_t tree;
+    for (const char* key : {"he", "she", "his", "hers"}) {
+        tree[key] = 1;
+    }
+    const matcher_t matcher = tree.build_matcher();
+
+    const std::vector<occurrence> expected{{1, "she"}, {2, "he"}, {2, "hers"}};
+    ASSERT_EQ(expected, scanned(matcher, "ushers"));
+    ASSERT_TRUE(scanned(matcher, "").empty());
+    ASSERT_TRUE(scanned(matcher, "xyz").empty());
+    // the root and one state per element of every key, shared prefixes once
+    ASSERT_EQ(1u + 6 + 3, matcher.size());
+    ASSERT_GT(matcher.memory_bytes(), 0u);
+}
+
+TEST(matcher, against_brute_force) {
+    auto randeng = std::default_random_engine();
+    for (const int keys : {1, 10, 300, 3000}) {
+        std::map<std::string, int> expected;
+        tree_t tree;
+        insert_random_keys(tree, expected, randeng, keys, 6, 'd');
+        const matcher_t matcher = tree.build_matcher();
+
+        for (int i = 0; i < 20; i++) {
+            const std::string text = random_key(randeng, 100, 'e');
+            ASSERT_EQ(occurrences(expected, text), scanned(matcher, text)) << keys << " " << text;
+        }
+    }
+}
+
+TEST(matcher, streams_across_buffers) {
+    auto randeng = std::default_random_engine();
+    std::map<std::string, int> expected;
+    tree_t tree;
+    insert_random_keys(tree, expected, randeng, 500, 8, 'c');
+    const matcher_t matcher = tree.build_matcher();
+    const std::string text = random_key(randeng, 1000, 'c');
+    const std::vector<occurrence> reference = occurrences(expected, text);
+
+    for (const std::size_t chunk : {1u, 3u, 7u, 64u, 10000u}) {
+        std::vector<occurrence> found;
+        matcher_t::scan_state state;
+        for (std::size_t pos = 0; pos < text.size(); pos += chunk) {
+            matcher.scan(state, std::string_view(text).substr(pos, chunk),
+                         [&](std::uint64_t begin, tree_t::value_type& val) { found.emplace_back(begin, val.first); });
+        }
+        ASSERT_EQ(text.size(), state.offset);
+        ASSERT_EQ(reference, found) << chunk;
+    }
+}
+
+TEST(matcher, stops_early) {
+    tree_t tree;
+    insert_unique_keys(tree);
+    const matcher_t matcher = tree.build_matcher();
+
+    // "aa" and "a" end at the second byte, "aab" is the first key ending at the third
+    std::vector<std::string> seen;
+    matcher_t::scan_state state;
+    const std::size_t n = matcher.scan(state, "aabx", [&](std::uint64_t, tree_t::value_type& val) {
+        seen.push_back(val.first);
+        return val.first != "aab";
+    });
+    ASSERT_EQ(4u, n);
+    const std::vector<std::string> first{"a", "aa", "a", "aab"};
+    ASSERT_EQ(first, seen);
+    ASSERT_EQ(3u, state.offset);
+
+    // the values can be changed through the matcher
+    matcher.scan("bb", [](std::uint64_t, tree_t::value_type& val) { val.second++; });
+    ASSERT_EQ(3, tree["b"]);
+    ASSERT_EQ(2, tree["bb"]);
+
+    tree_t empty;
+    ASSERT_EQ(0u, empty.build_matcher().scan("abc", [](std::uint64_t, tree_t::value_type&) { ADD_FAILURE(); }));
+}
+
+TEST(matcher, byte_vector_keys) {
+    radix_tree<std::vector<std::uint8_t>, int> tree;
+    tree[{0x00, 0xff}] = 1;
+    tree[{0xff}] = 2;
+    tree[{}] = 3;
+    const auto matcher = tree.build_matcher();
+
+    std::vector<std::pair<std::uint64_t, int>> found;
+    matcher.scan(std::string_view("\x01\x00\xff\xff", 4),
+                 [&](std::uint64_t begin, auto& val) { found.emplace_back(begin, val.second); });
+    const std::vector<std::pair<std::uint64_t, int>> expected{{1, 1}, {2, 2}, {3, 2}};
+    ASSERT_EQ(expected, found);
+}
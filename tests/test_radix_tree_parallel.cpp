@@ -0,0 +1,228 @@
+#include "common.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+std::vector<std::pair<std::string, int>> make_values(const int n, std::default_random_engine& randeng) {
+    std::uniform_int_distribution<int> len_dist(0, 12);
+    std::uniform_int_distribution<int> char_dist('a', 'e');
+
+    std::vector<std::pair<std::string, int>> values;
+    for (int i = 0; i < n; i++) {
+        // a long shared prefix for half the keys, to force splitting deep below the root
+        std::string key = i % 2 == 0 ? "https://www.example.com/" : "";
+        for (int len = len_dist(randeng); len > 0; len--) {
+            key += static_cast<char>(char_dist(randeng));
+        }
+        values.emplace_back(key, i);
+    }
+    return values;
+}
+
+void assert_same(tree_t& expected, tree_t& tree) {
+    ASSERT_EQ(expected.size(), tree.size());
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), tree.begin(), tree.end()));
+    // the same set of keys has only one radix tree
+    ASSERT_EQ(expected.stats().internal_nodes, tree.stats().internal_nodes);
+    for (auto it = expected.begin(); it != expected.end(); ++it) {
+        auto found = tree.find(it->first);
+        ASSERT_NE(tree.end(), found) << it->first;
+        ASSERT_EQ(it->second, found->second);
+    }
+    std::vector<tree_t::iterator> vec;
+    tree.prefix_match("https://www.example.com/a", vec);
+    std::vector<tree_t::iterator> expected_vec;
+    expected.prefix_match("https://www.example.com/a", expected_vec);
+    ASSERT_EQ(expected_vec.size(), vec.size());
+}
+
+} // namespace
+
+TEST(build_parallel, same_as_insert) {
+    auto randeng = std::default_random_engine();
+    const auto values = make_values(20000, randeng);
+
+    tree_t expected;
+    expected.insert(values.begin(), values.end());
+
+    for (const unsigned threads : {1u, 2u, 4u, 7u}) {
+        tree_t tree;
+        tree.build_parallel(values.begin(), values.end(), threads);
+        assert_same(expected, tree);
+    }
+}
+
+TEST(build_parallel, into_filled_tree) {
+    auto randeng = std::default_random_engine();
+    const auto values = make_values(20000, randeng);
+    const auto more = make_values(20000, randeng);
+
+    tree_t expected;
+    expected.insert(values.begin(), values.end());
+    expected.insert(more.begin(), more.end());
+
+    tree_t tree;
+    tree.enable_hash_index();
+    tree.enable_bloom_filter();
+    tree.insert(values.begin(), values.end());
+    tree.build_parallel(more.begin(), more.end(), 4);
+    assert_same(expected, tree);
+
+    for (const auto& [key, value] : more) {
+        ASSERT_TRUE(tree.erase(key) == expected.erase(key));
+    }
+    assert_same(expected, tree);
+    ASSERT_EQ(tree.end(), tree.find(more.front().first));
+}
+
+TEST(build_parallel, counters) {
+    auto randeng = std::default_random_engine();
+    const auto values = make_values(20000, randeng);
+
+    radix_tree<std::string, int, std::less<>, radix_tree_counters> tree;
+    tree.build_parallel(values.begin(), values.end(), 4);
+    const radix_counters counters = tree.instrumentation().snapshot();
+    ASSERT_GT(counters.node_allocs, counters.node_frees);
+
+    tree.clear();
+    ASSERT_EQ(tree.instrumentation().snapshot().node_allocs, tree.instrumentation().snapshot().node_frees);
+}
+
+TEST(parallel_for_each, visits_every_element_once) {
+    auto randeng = std::default_random_engine();
+    const auto values = make_values(20000, randeng);
+
+    tree_t tree;
+    tree.insert(values.begin(), values.end());
+
+    for (const unsigned threads : {1u, 3u, 8u}) {
+        std::atomic<std::size_t> visits{0};
+        tree.parallel_for_each(
+            [&](tree_t::value_type& val) {
+                val.second++;
+                visits++;
+            },
+            threads);
+        ASSERT_EQ(tree.size(), visits.load());
+    }
+
+    tree_t expected;
+    expected.insert(values.begin(), values.end());
+    for (auto it = expected.begin(); it != expected.end(); ++it) {
+        ASSERT_EQ(it->second + 3, tree[it->first]);
+    }
+
+    tree_t empty;
+    empty.parallel_for_each([](tree_t::value_type&) { FAIL(); });
+}
+
+TEST(parallel_reduce, combines_in_key_order) {
+    auto randeng = std::default_random_engine();
+    const auto values = make_values(20000, randeng);
+
+    tree_t tree;
+    tree.insert(values.begin(), values.end());
+
+    const auto key_of = [](const tree_t::value_type& val) { return val.first + ","; };
+    const auto concat = [](std::string a, const std::string& b) { return a += b; };
+
+    for (const std::string prefix : {"", "https://www.example.com/", "https://www.example.com/ab", "e", "zz"}) {
+        std::string expected = ">";
+        long expected_sum = 0;
+        for (auto it = tree.begin(); it != tree.end(); ++it) {
+            if (it->first.starts_with(prefix)) {
+                expected += it->first + ",";
+                expected_sum += it->second;
+            }
+        }
+
+        for (const unsigned threads : {1u, 4u}) {
+            ASSERT_EQ(expected, tree.parallel_reduce(prefix, std::string(">"), key_of, concat, threads)) << prefix;
+            ASSERT_EQ(expected_sum,
+                      tree.parallel_reduce(
+                          prefix, 0L, [](const tree_t::value_type& val) { return long(val.second); },
+                          std::plus<long>(), threads));
+        }
+    }
+}
+
+TEST(apply_batch, same_as_one_by_one) {
+    auto randeng = std::default_random_engine();
+    const auto values = make_values(20000, randeng);
+
+    for (const unsigned threads : {1u, 4u}) {
+        tree_t expected, tree;
+        tree.enable_hash_index();
+        tree.enable_bloom_filter();
+        expected.insert(values.begin(), values.end());
+        tree.insert(values.begin(), values.end());
+
+        for (int round = 0; round < 3; round++) {
+            const auto keys = make_values(20000, randeng);
+            std::vector<radix_mutation<std::string, int>> batch;
+            for (const auto& [key, value] : keys) {
+                const auto op = static_cast<radix_mutation_op>(randeng() % 3);
+                batch.push_back({op, key, value});
+                switch (op) {
+                case radix_mutation_op::insert: expected.insert(tree_t::value_type(key, value)); break;
+                case radix_mutation_op::assign: expected[key] = value; break;
+                case radix_mutation_op::erase: expected.erase(key); break;
+                }
+            }
+
+            tree.apply_batch(batch, threads);
+            assert_same(expected, tree);
+            for (const auto& [key, value] : keys) {
+                ASSERT_EQ(expected.find(key) == expected.end(), tree.find(key) == tree.end()) << key;
+            }
+        }
+    }
+}
+
+TEST(apply_batch, erase_everything) {
+    auto randeng = std::default_random_engine();
+    const auto values = make_values(20000, randeng);
+
+    tree_t tree;
+    tree.enable_hash_index();
+    tree.insert(values.begin(), values.end());
+
+    std::vector<radix_mutation<std::string, int>> batch;
+    for (const auto& [key, value] : values) {
+        batch.push_back({radix_mutation_op::erase, key});
+    }
+    tree.apply_batch(batch, 4);
+
+    ASSERT_EQ(0u, tree.size());
+    ASSERT_EQ(tree.begin(), tree.end());
+    // only the root is left
+    ASSERT_EQ(1u, tree.stats().internal_nodes);
+    tree["a"] = 1;
+    ASSERT_EQ(1, tree.find("a")->second);
+}
+
+TEST(apply_batch, erases_of_absent_keys_next_to_inserts) {
+    tree_t expected, tree;
+    tree["abq"] = 0;
+    expected["abq"] = 0;
+
+    // the group of the erases finds nothing and leaves an empty point next to those of the inserts
+    std::vector<radix_mutation<std::string, int>> batch;
+    for (int i = 0; i < 250; i++) {
+        batch.push_back({radix_mutation_op::erase, "ac" + std::to_string(i)});
+    }
+    for (int i = 0; i < 200; i++) {
+        batch.push_back({radix_mutation_op::insert, "ab" + std::to_string(i), i});
+        expected["ab" + std::to_string(i)] = i;
+    }
+    for (int i = 0; i < 150; i++) {
+        batch.push_back({radix_mutation_op::insert, "z" + std::to_string(i), i});
+        expected["z" + std::to_string(i)] = i;
+    }
+    tree.apply_batch(batch, 2);
+
+    ASSERT_EQ(351u, tree.size());
+    assert_same(expected, tree);
+}
@@ -0,0 +1,167 @@
+#include "common.hpp"
+
+#include <regex>
+#include <stdexcept>
+
+namespace {
+
+using counted_tree_t = radix_tree<std::string, int, std::less<std::string>, radix_tree_counters>;
+
+std::vector<std::string> pattern_found(tree_t& tree, const radix_dfa& dfa) {
+    std::vector<std::string> found;
+    tree.match_pattern(dfa, [&](tree_t::value_type& val) { found.push_back(val.first); });
+    return found;
+}
+
+} // namespace
+
+TEST(radix_dfa, glob) {
+    const radix_dfa dfa = radix_dfa::glob("svc-*-prod/*.log");
+    ASSERT_TRUE(dfa.matches("svc-a-prod/x.log"));
+    ASSERT_TRUE(dfa.matches("svc--prod/.log"));
+    ASSERT_TRUE(dfa.matches("svc-a-prod/b-prod/c.log"));
+    ASSERT_FALSE(dfa.matches("svc-a-prod/x.log.1"));
+    ASSERT_FALSE(dfa.matches("svc-a-dev/x.log"));
+    ASSERT_FALSE(dfa.matches(""));
+    ASSERT_EQ("svc-", dfa.literal_prefix());
+
+    const radix_dfa paths = radix_dfa::glob("svc-*-prod/*.log", '/');
+    ASSERT_TRUE(paths.matches("svc-a-prod/x.log"));
+    ASSERT_FALSE(paths.matches("svc-a-prod/b-prod/c.log"));
+    ASSERT_FALSE(paths.matches("svc-a/b-prod/c.log"));
+    ASSERT_FALSE(radix_dfa::glob("a?b", '/').matches("a/b"));
+    ASSERT_FALSE(radix_dfa::glob("a[!x]b", '/').matches("a/b"));
+
+    const radix_dfa sets = radix_dfa::glob("[a-c]?[!0-9]\\*");
+    ASSERT_TRUE(sets.matches("bzz*"));
+    ASSERT_TRUE(sets.matches("a1]*"));
+    ASSERT_FALSE(sets.matches("dzz*"));
+    ASSERT_FALSE(sets.matches("az1*"));
+    ASSERT_FALSE(sets.matches("azzz"));
+    ASSERT_EQ("", sets.literal_prefix());
+
+    ASSERT_TRUE(radix_dfa::glob("[]x]").matches("]"));
+    ASSERT_TRUE(radix_dfa::glob("a[b").matches("a[b"));
+    ASSERT_TRUE(radix_dfa::glob("*").matches(""));
+    ASSERT_TRUE(radix_dfa::glob("").matches(""));
+    ASSERT_FALSE(radix_dfa::glob("").matches("a"));
+}
+
+TEST(radix_dfa, regex_against_std_regex) {
+    const std::vector<std::string> patterns{
+        "a(b|c)*d", "(ab|a)(bc|c)?", "[^ab]+c?", "a.b", "(a|b)*abb", "x?y?z?", "\\w+\\d", "(a+|b+)+c", "[a-c]*d[^a]",
+        "",         "a|",            "(|a)b",    "c+.*",
+    };
+    auto randeng = std::default_random_engine();
+    for (const auto& pattern : patterns) {
+        const radix_dfa dfa = radix_dfa::regex(pattern);
+        const std::regex reference(pattern);
+        for (int i = 0; i < 2000; i++) {
+            const std::string key = random_key(randeng, 6, 'e') + (i % 3 == 0 ? "1" : "");
+            ASSERT_EQ(std::regex_match(key, reference), dfa.matches(key)) << pattern << " " << key;
+        }
+    }
+
+    ASSERT_EQ("abc", radix_dfa::regex("^abc(d|e)$").literal_prefix());
+    ASSERT_EQ("a", radix_dfa::regex("ab|ac").literal_prefix());
+    ASSERT_EQ("", radix_dfa::regex("a?b").literal_prefix());
+    ASSERT_EQ("ab", radix_dfa::regex("ab").literal_prefix());
+    ASSERT_TRUE(radix_dfa::regex("a\\.b\\n").matches("a.b\n"));
+    ASSERT_FALSE(radix_dfa::regex("a\\.b").matches("axb"));
+    ASSERT_TRUE(radix_dfa::regex("[\\d.]+").matches("1.5"));
+}
+
+TEST(radix_dfa, regex_errors) {
+    for (const char* pattern : {"(ab", "ab)", "*a", "a{2}", "a\\1", "[ab", "a\\", "[z-a]"}) {
+        ASSERT_THROW(radix_dfa::regex(pattern), std::invalid_argument) << pattern;
+    }
+}
+
+TEST(match_pattern, against_brute_force) {
+    auto randeng = std::default_random_engine();
+    tree_t tree;
+    for (int i = 0; i < 5000; i++) {
+        tree[random_key(randeng, 8, 'd')] = i;
+    }
+
+    for (const char* glob : {"*", "a*", "ab*c", "*dd", "?b?", "[ab]*[!a]", "abc", "ba?c*", "e*", ""}) {
+        const radix_dfa dfa = radix_dfa::glob(glob);
+        const auto expected = keys_where(tree, [&](const std::string& key) { return dfa.matches(key); });
+        ASSERT_EQ(expected, pattern_found(tree, dfa)) << glob;
+    }
+
+    for (const char* pattern : {"(ab)+c?", "a[bc]*d", "d|dd|ddd", "(a|b)*c(a|b)*"}) {
+        const radix_dfa dfa = radix_dfa::regex(pattern);
+        const std::regex reference(pattern);
+        const auto expected =
+            keys_where(tree, [&](const std::string& key) { return std::regex_match(key, reference); });
+        ASSERT_EQ(expected, pattern_found(tree, dfa)) << pattern;
+    }
+}
+
+TEST(match_pattern, stops_early) {
+    tree_t tree;
+    insert_unique_keys(tree);
+    const radix_dfa dfa = radix_dfa::glob("a*");
+
+    std::vector<std::string> seen;
+    const std::size_t n = tree.match_pattern(dfa, [&](tree_t::value_type& val) {
+        seen.push_back(val.first);
+        return val.first != "aab";
+    });
+    ASSERT_EQ(4u, n);
+    const std::vector<std::string> first{"a", "aa", "aaa", "aab"};
+    ASSERT_EQ(first, seen);
+
+    ASSERT_EQ(2u, tree.match_pattern(dfa, [](tree_t::value_type& val) { val.second = 5; }, 2));
+    ASSERT_EQ(5, tree["aa"]);
+    ASSERT_EQ(1, tree["aaa"]);
+
+    tree_t empty;
+    ASSERT_EQ(0u, empty.match_pattern(dfa, [](tree_t::value_type&) { ADD_FAILURE(); }));
+    ASSERT_EQ(0u, tree.match_pattern(radix_dfa::glob("c*"), [](tree_t::value_type&) { ADD_FAILURE(); }));
+}
+
+TEST(match_pattern, visits_the_matching_structure) {
+    counted_tree_t tree;
+    auto randeng = std::default_random_engine();
+    for (const char* service : {"auth", "billing", "search", "mail"}) {
+        for (const char* env : {"prod", "dev", "test"}) {
+            for (int i = 0; i < 2000; i++) {
+                tree[std::string("svc-") + service + "-" + env + "/" + random_key(randeng, 8, 'z') + ".log"] = i;
+            }
+        }
+    }
+    const std::size_t keys = tree.size();
+    const auto st = tree.stats();
+
+    // matches whatever follows the prefix, so the subtree below it is walked
+    std::size_t found = 0;
+    tree.instrumentation().reset();
+    found = tree.match_pattern(radix_dfa::glob("svc-auth-prod/*"), [](counted_tree_t::value_type&) {});
+    ASSERT_GT(found, 1000u);
+    ASSERT_LT(tree.instrumentation().snapshot().node_visits * 6, st.internal_nodes);
+
+    // the other environments are skipped on their first edge
+    tree.instrumentation().reset();
+    found = tree.match_pattern(radix_dfa::glob("svc-*-prod/a*.log", '/'), [](counted_tree_t::value_type&) {});
+    ASSERT_GT(found, 0u);
+    ASSERT_LT(tree.instrumentation().snapshot().node_visits * 10, st.internal_nodes);
+
+    // nothing but the prefix is touched when it leads nowhere
+    tree.instrumentation().reset();
+    ASSERT_EQ(0u, tree.match_pattern(radix_dfa::regex("svc-(ftp|dns)-.*"), [](counted_tree_t::value_type&) {}));
+    ASSERT_LT(tree.instrumentation().snapshot().node_visits, 10u);
+    ASSERT_EQ(keys, tree.size());
+}
+
+TEST(match_pattern, byte_vector_keys) {
+    radix_tree<std::vector<std::uint8_t>, int> tree;
+    tree[{'a', 'b'}] = 1;
+    tree[{'a', 'c', 'c'}] = 2;
+    tree[{'b'}] = 3;
+
+    std::vector<int> found;
+    tree.match_pattern(radix_dfa::regex("ac+|b"), [&](auto& val) { found.push_back(val.second); });
+    ASSERT_EQ((std::vector<int>{2, 3}), found);
+}
@@ -0,0 +1,98 @@
+#include "common.hpp"
+
+namespace {
+
+std::vector<std::string> make_keys(const int n) {
+    auto randeng = std::default_random_engine();
+    std::uniform_int_distribution<int> len_dist(1, 10);
+    std::uniform_int_distribution<int> char_dist('a', 'f');
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < n; i++) {
+        std::string key;
+        for (int len = len_dist(randeng); len > 0; len--) {
+            key += static_cast<char>(char_dist(randeng));
+        }
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+std::size_t pool_bytes(const radix_tree_stats& st) {
+    return st.node_bytes + st.free_node_bytes;
+}
+
+} // namespace
+
+TEST(pool, erased_nodes_are_reused) {
+    const std::vector<std::string> keys = make_keys(5000);
+
+    tree_t tree;
+    for (const auto& key : keys) {
+        tree[key] = 1;
+    }
+    const std::size_t bytes = pool_bytes(tree.stats());
+
+    for (int round = 0; round < 3; round++) {
+        for (std::size_t i = 0; i < keys.size(); i += 2) {
+            tree.erase(keys[i]);
+        }
+        ASSERT_EQ(bytes, pool_bytes(tree.stats()));
+        for (std::size_t i = 0; i < keys.size(); i += 2) {
+            tree[keys[i]] = 2;
+        }
+        ASSERT_EQ(bytes, pool_bytes(tree.stats()));
+    }
+
+    for (const auto& key : keys) {
+        ASSERT_NE(tree.end(), tree.find(key)) << key;
+    }
+}
+
+TEST(pool, clear_releases_the_chunks) {
+    tree_t tree;
+    for (const auto& key : make_keys(1000)) {
+        tree[key] = 1;
+    }
+    ASSERT_GT(tree.stats().free_node_bytes + tree.stats().node_bytes, 0u);
+
+    tree.clear();
+    ASSERT_EQ(0u, tree.stats().heap_bytes);
+
+    tree["abc"] = 1;
+    ASSERT_EQ(1, tree.find("abc")->second);
+}
+
+TEST(pool, internal_nodes_hold_no_value) {
+    tree_t tree;
+    insert_unique_keys(tree);
+    const auto st = tree.stats();
+    ASSERT_GT(st.internal_nodes, 0u);
+    ASSERT_EQ(st.leaf_nodes * sizeof(tree_t::value_type), st.value_bytes);
+}
+
+TEST(pool, parallel_parts_are_merged) {
+    using counted_tree_t = radix_tree<std::string, int, std::less<std::string>, radix_tree_counters>;
+
+    const std::vector<std::string> keys = make_keys(20000);
+    std::vector<counted_tree_t::value_type> values;
+    for (const auto& key : keys) {
+        values.emplace_back(key, 1);
+    }
+
+    counted_tree_t tree;
+    tree.build_parallel(values.begin(), values.end(), 4);
+
+    const auto st = tree.stats();
+    const auto c = tree.instrumentation().snapshot();
+    ASSERT_EQ(st.internal_nodes + st.leaf_nodes, c.node_allocs - c.node_frees);
+
+    for (const auto& key : keys) {
+        tree.erase(key);
+    }
+    // only the root is left
+    ASSERT_EQ(1u, tree.stats().internal_nodes);
+    tree.clear();
+    ASSERT_EQ(0u, tree.stats().heap_bytes);
+    ASSERT_EQ(tree.instrumentation().snapshot().node_allocs, tree.instrumentation().snapshot().node_frees);
+}
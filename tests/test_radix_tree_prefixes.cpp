@@ -0,0 +1,108 @@
+#include "common.hpp"
+
+namespace {
+
+using counted_tree_t = radix_tree<std::string, int, std::less<std::string>, radix_tree_counters>;
+
+std::vector<std::string> prefixes_found(tree_t& tree, const std::string& key) {
+    std::vector<std::string> found;
+    const std::size_t n = tree.for_each_prefix_of(key, [&](tree_t::value_type& val) { found.push_back(val.first); });
+    EXPECT_EQ(found.size(), n);
+    return found;
+}
+
+} // namespace
+
+TEST(prefixes_of, paths) {
+    tree_t tree;
+    for (const char* key : {"/", "/api", "/api/v2", "/api/v2/users", "/apix", "/static"}) {
+        tree[key] = 1;
+    }
+
+    const std::vector<std::string> expected{"/", "/api", "/api/v2"};
+    ASSERT_EQ(expected, prefixes_found(tree, "/api/v2/orders"));
+    ASSERT_EQ(std::vector<std::string>{"/"}, prefixes_found(tree, "/ap"));
+    ASSERT_TRUE(prefixes_found(tree, "api").empty());
+    ASSERT_TRUE(prefixes_found(tree, "").empty());
+
+    tree[""] = 2;
+    std::vector<tree_t::iterator> vec;
+    tree.prefixes_of("/api/v2/users", vec);
+    ASSERT_EQ(5u, vec.size());
+    ASSERT_EQ("", vec.front()->first);
+    ASSERT_EQ(2, vec.front()->second);
+    ASSERT_EQ("/api/v2/users", vec.back()->first);
+
+    tree_t empty;
+    empty.prefixes_of("/api", vec);
+    ASSERT_TRUE(vec.empty());
+}
+
+TEST(prefixes_of, reverse_order) {
+    // the children are scanned rather than looked up in the child map
+    radix_tree<std::string, int, std::greater<std::string>> tree;
+    for (const char* key : {"/", "/api", "/api/v2", "/apix", "/static", "a"}) {
+        tree[key] = 1;
+    }
+
+    std::vector<radix_tree<std::string, int, std::greater<std::string>>::iterator> vec;
+    tree.prefixes_of("/api/v2/orders", vec);
+    std::vector<std::string> found;
+    for (const auto& it : vec) {
+        found.push_back(it->first);
+    }
+    ASSERT_EQ((std::vector<std::string>{"/", "/api", "/api/v2"}), found);
+}
+
+TEST(prefixes_of, against_brute_force) {
+    auto randeng = std::default_random_engine();
+    tree_t tree;
+    for (int i = 0; i < 2000; i++) {
+        tree[random_key(randeng, 8, 'c')] = i;
+    }
+
+    for (int i = 0; i < 1000; i++) {
+        const std::string key = random_key(randeng, 10, 'c');
+        // shorter prefixes come first in key order
+        const auto expected = keys_where(tree, [&](const std::string& prefix) { return key.starts_with(prefix); });
+        ASSERT_EQ(expected, prefixes_found(tree, key)) << key;
+
+        // the deepest of them is the longest match
+        const auto it = tree.longest_match(key);
+        ASSERT_EQ(expected.empty(), it == tree.end());
+        if (!expected.empty()) {
+            ASSERT_EQ(expected.back(), it->first);
+        }
+    }
+}
+
+TEST(prefixes_of, stops_early) {
+    tree_t tree;
+    insert_unique_keys(tree);
+
+    std::vector<std::string> seen;
+    const std::size_t n = tree.for_each_prefix_of("abba", [&](tree_t::value_type& val) {
+        seen.push_back(val.first);
+        val.second = 7;
+        return val.first.size() < 2;
+    });
+    ASSERT_EQ(2u, n);
+    ASSERT_EQ((std::vector<std::string>{"a", "ab"}), seen);
+    ASSERT_EQ(7, tree["ab"]);
+    ASSERT_EQ(1, tree["abb"]);
+}
+
+TEST(prefixes_of, one_descent) {
+    auto randeng = std::default_random_engine();
+    counted_tree_t tree;
+    for (int i = 0; i < 20000; i++) {
+        tree[random_key(randeng, 12, 'c')] = i;
+    }
+
+    const std::string key = "abcabcabcabcabc";
+    tree.instrumentation().reset();
+    const std::size_t n = tree.for_each_prefix_of(key, [](counted_tree_t::value_type&) {});
+    ASSERT_GT(n, 5u);
+    // no more nodes than the key has elements, and each entered once
+    ASSERT_LE(tree.instrumentation().snapshot().node_visits, key.size() + 1);
+}
@@ -0,0 +1,132 @@
+#include "common.hpp"
+
+#include <set>
+
+namespace {
+
+std::vector<std::string> random_keys(std::default_random_engine& randeng, const size_t count) {
+    std::uniform_int_distribution<int> len_dist(0, 6);
+    std::uniform_int_distribution<int> char_dist('a', 'c');
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < count; i++) {
+        std::string key(len_dist(randeng), ' ');
+        for (auto& c : key) {
+            c = static_cast<char>(char_dist(randeng));
+        }
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+std::vector<std::string> collect(const radix_set_view<std::string, int, std::less<std::string>>& view) {
+    std::vector<std::string> result;
+    for (const auto& [key, value] : view) {
+        result.push_back(key);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(set_ops, empty_trees) {
+    tree_t lhs, rhs;
+    ASSERT_TRUE(collect(lhs.set_intersection(rhs)).empty());
+    ASSERT_TRUE(collect(lhs.set_union(rhs)).empty());
+
+    rhs["abc"] = 1;
+    rhs["abd"] = 2;
+    ASSERT_TRUE(collect(lhs.set_intersection(rhs)).empty());
+    ASSERT_TRUE(collect(lhs.set_difference(rhs)).empty());
+    ASSERT_EQ(std::vector<std::string>({"abc", "abd"}), collect(lhs.set_union(rhs)));
+    ASSERT_EQ(std::vector<std::string>({"abc", "abd"}), collect(rhs.set_difference(lhs)));
+}
+
+TEST(set_ops, differently_split_edges) {
+    tree_t lhs, rhs;
+    lhs["abcdef"] = 1;
+    lhs["abcdxy"] = 2;
+    lhs["ab"] = 3;
+    lhs[""] = 4;
+    rhs["abcdef"] = 10;
+    rhs["abz"] = 20;
+    rhs["a"] = 30;
+    rhs[""] = 40;
+
+    ASSERT_EQ(std::vector<std::string>({"", "abcdef"}), collect(lhs.set_intersection(rhs)));
+    ASSERT_EQ(std::vector<std::string>({"ab", "abcdxy"}), collect(lhs.set_difference(rhs)));
+    ASSERT_EQ(std::vector<std::string>({"a", "ab", "abcdxy", "abz"}), collect(lhs.set_symmetric_difference(rhs)));
+    ASSERT_EQ(std::vector<std::string>({"", "a", "ab", "abcdef", "abcdxy", "abz"}), collect(lhs.set_union(rhs)));
+}
+
+TEST(set_ops, bytes_above_0x7f) {
+    tree_t lhs, rhs;
+    lhs["a"] = 1;
+    lhs["\xc3\xa9"] = 2;
+    lhs["x\xff"] = 3;
+    rhs["z"] = 10;
+    rhs["x\x01"] = 20;
+    rhs["\xc3\xa9t\xc3\xa9"] = 30;
+
+    // in the order of std::less<std::string>, which takes the bytes as unsigned
+    ASSERT_EQ(std::vector<std::string>({"a", "x\x01", "x\xff", "z", "\xc3\xa9", "\xc3\xa9t\xc3\xa9"}),
+              collect(lhs.set_union(rhs)));
+}
+
+TEST(set_ops, left_and_right_elements) {
+    tree_t lhs, rhs;
+    lhs["common"] = 1;
+    lhs["left"] = 2;
+    rhs["common"] = 3;
+    rhs["right"] = 4;
+
+    auto view = lhs.set_union(rhs);
+    auto it = view.begin();
+    ASSERT_EQ("common", it->first);
+    ASSERT_EQ(1, it.left()->second);
+    ASSERT_EQ(3, it.right()->second);
+    ++it;
+    ASSERT_EQ("left", it->first);
+    ASSERT_EQ(lhs.find("left"), it.left());
+    ASSERT_EQ(rhs.end(), it.right());
+    ++it;
+    ASSERT_EQ("right", it->first);
+    ASSERT_EQ(lhs.end(), it.left());
+    ASSERT_EQ(rhs.find("right"), it.right());
+    ++it;
+    ASSERT_EQ(view.end(), it);
+}
+
+TEST(set_ops, same_as_std_algorithms) {
+    auto randeng = std::default_random_engine();
+    for (int round = 0; round < 20; round++) {
+        SCOPED_TRACE(round);
+        const auto lhs_keys = random_keys(randeng, 200);
+        const auto rhs_keys = random_keys(randeng, 200);
+        const std::set<std::string> lhs_set(lhs_keys.begin(), lhs_keys.end());
+        const std::set<std::string> rhs_set(rhs_keys.begin(), rhs_keys.end());
+
+        tree_t lhs, rhs;
+        for (const auto& key : lhs_keys) {
+            lhs[key] = 1;
+        }
+        for (const auto& key : rhs_keys) {
+            rhs[key] = 2;
+        }
+
+        std::vector<std::string> expected;
+        std::ranges::set_intersection(lhs_set, rhs_set, std::back_inserter(expected));
+        ASSERT_EQ(expected, collect(lhs.set_intersection(rhs)));
+
+        expected.clear();
+        std::ranges::set_difference(lhs_set, rhs_set, std::back_inserter(expected));
+        ASSERT_EQ(expected, collect(lhs.set_difference(rhs)));
+
+        expected.clear();
+        std::ranges::set_symmetric_difference(lhs_set, rhs_set, std::back_inserter(expected));
+        ASSERT_EQ(expected, collect(lhs.set_symmetric_difference(rhs)));
+
+        expected.clear();
+        std::ranges::set_union(lhs_set, rhs_set, std::back_inserter(expected));
+        ASSERT_EQ(expected, collect(lhs.set_union(rhs)));
+    }
+}
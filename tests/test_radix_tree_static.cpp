@@ -0,0 +1,101 @@
+#include "common.hpp"
+
+#include <radix_tree_static.hpp>
+
+namespace {
+
+enum class method { get, head, post, put, patch, del, options };
+
+constexpr auto methods = make_radix_static_tree<method>({{"GET", method::get},
+                                                         {"HEAD", method::head},
+                                                         {"POST", method::post},
+                                                         {"PUT", method::put},
+                                                         {"PATCH", method::patch},
+                                                         {"DELETE", method::del},
+                                                         {"OPTIONS", method::options}});
+
+static_assert(methods.size() == 7);
+static_assert(methods.find("PUT")->second == method::put);
+static_assert(methods.find("PATCH")->second == method::patch);
+static_assert(methods.find("PU") == methods.end());
+static_assert(methods.find("PUTS") == methods.end());
+static_assert(!methods.contains("get"));
+static_assert(methods.longest_match("POSTAL")->second == method::post);
+static_assert(methods.longest_match("PO") == methods.end());
+static_assert(methods.prefix_range("P").second - methods.prefix_range("P").first == 3);
+static_assert(methods.begin()->first == "DELETE");
+
+} // namespace
+
+TEST(radix_static_tree, against_radix_tree) {
+    constexpr std::size_t n = 40;
+    auto randeng = std::default_random_engine();
+
+    for (int round = 0; round < 20; round++) {
+        std::set<std::string> distinct;
+        while (distinct.size() < n) {
+            distinct.insert(random_key(randeng, 6, 'c'));
+        }
+        const std::vector<std::string> keys(distinct.begin(), distinct.end());
+        std::array<std::pair<std::string_view, int>, n> elements;
+        tree_t tree;
+        for (std::size_t i = 0; i < n; i++) {
+            // reversed, so the constructor has to sort them
+            elements[n - 1 - i] = {keys[i], static_cast<int>(i)};
+            tree[keys[i]] = static_cast<int>(i);
+        }
+        const radix_static_tree<int, n> fixed(elements);
+
+        ASSERT_TRUE(std::ranges::equal(keys, fixed, {}, {}, [](const auto& e) { return std::string(e.first); }));
+        for (int i = 0; i < 200; i++) {
+            const std::string key = random_key(randeng, 8, 'c');
+
+            const auto it = tree.find(key);
+            const auto fixed_it = fixed.find(key);
+            ASSERT_EQ(it == tree.end(), fixed_it == fixed.end()) << key;
+            if (it != tree.end()) {
+                ASSERT_EQ(it->second, fixed_it->second);
+            }
+
+            const auto longest = tree.longest_match(key);
+            const auto fixed_longest = fixed.longest_match(key);
+            ASSERT_EQ(longest == tree.end(), fixed_longest == fixed.end()) << key;
+            if (longest != tree.end()) {
+                ASSERT_EQ(longest->second, fixed_longest->second) << key;
+            }
+
+            vector_found_t found;
+            tree.prefix_match(key, found);
+            std::vector<radix_static_tree<int, n>::const_iterator> fixed_found;
+            fixed.prefix_match(key, fixed_found);
+            map_found_t expected = vec_found_to_map(found);
+            map_found_t actual;
+            for (const auto& e : fixed_found) {
+                actual.emplace(e->first, e->second);
+            }
+            ASSERT_EQ(expected, actual) << key;
+        }
+    }
+}
+
+TEST(radix_static_tree, empty_and_single_keys) {
+    constexpr radix_static_tree<int, 0> none(std::array<std::pair<std::string_view, int>, 0>{});
+    static_assert(none.empty());
+    static_assert(none.find("") == none.end());
+    static_assert(none.longest_match("a") == none.end());
+
+    constexpr auto only_empty = make_radix_static_tree<int>({{"", 1}});
+    static_assert(only_empty.find("")->second == 1);
+    static_assert(only_empty.find("a") == only_empty.end());
+    static_assert(only_empty.longest_match("abc")->second == 1);
+
+    const auto with_empty = make_radix_static_tree<int>({{"ab", 2}, {"", 1}, {"a", 3}});
+    ASSERT_EQ(1, with_empty.find("")->second);
+    ASSERT_EQ(3, with_empty.longest_match("ac")->second);
+    ASSERT_EQ(2, with_empty.longest_match("abc")->second);
+    ASSERT_EQ(3, with_empty.prefix_range("").second - with_empty.prefix_range("").first);
+}
+
+TEST(radix_static_tree, duplicate_keys) {
+    ASSERT_THROW(make_radix_static_tree<int>({{"a", 1}, {"b", 2}, {"a", 3}}), std::invalid_argument);
+}
@@ -0,0 +1,69 @@
+#include "common.hpp"
+
+TEST(stats, empty_tree) {
+    tree_t tree;
+    const auto st = tree.stats();
+    ASSERT_EQ(0u, st.internal_nodes);
+    ASSERT_EQ(0u, st.leaf_nodes);
+    ASSERT_EQ(0u, st.heap_bytes);
+}
+
+TEST(stats, complex_tree) {
+    tree_t tree;
+
+    tree["abcdef"] = 1;
+    tree["abcdege"] = 2;
+    tree["bcdef"] = 3;
+    tree["cd"] = 4;
+    tree["ce"] = 5;
+    tree["c"] = 6;
+
+    // (root) -> abcde -> {f -> $, ge -> $}, bcdef -> $, c -> {$, d -> $, e -> $}
+    const auto st = tree.stats();
+    ASSERT_EQ(8u, st.internal_nodes);
+    ASSERT_EQ(6u, st.leaf_nodes);
+
+    ASSERT_EQ(5u, st.fanout[1]);
+    ASSERT_EQ(1u, st.fanout[2]);
+    ASSERT_EQ(2u, st.fanout[3]);
+
+    ASSERT_EQ(2u, st.depth[2]);
+    ASSERT_EQ(4u, st.depth[3]);
+
+    ASSERT_EQ(16u, st.edge_label_length);
+    // every node but the root is a key of its parent's child map
+    ASSERT_EQ(13 * sizeof(std::string), st.duplicated_key_bytes);
+    // only leaves hold a value
+    ASSERT_EQ(6 * sizeof(tree_t::value_type), st.value_bytes);
+    ASSERT_EQ(st.node_bytes + st.free_node_bytes + st.map_entry_bytes + st.value_bytes, st.heap_bytes);
+}
+
+TEST(stats, long_keys_are_counted_on_the_heap) {
+    tree_t tree;
+    const std::string prefix(100, 'x');
+    tree[prefix + "a"] = 1;
+    tree[prefix + "b"] = 2;
+
+    const auto st = tree.stats();
+    ASSERT_EQ(102u, st.edge_label_length);
+    ASSERT_GT(st.edge_label_bytes, 100u);
+    ASSERT_GT(st.duplicated_key_bytes, 100u);
+    ASSERT_GT(st.value_bytes, 2 * 101u);
+    ASSERT_GT(st.heap_bytes, st.node_bytes + st.map_entry_bytes + st.value_bytes);
+}
+
+TEST(stats, counts_every_leaf) {
+    auto randeng = std::default_random_engine();
+    std::vector<std::string> unique_keys = get_unique_keys();
+    std::ranges::shuffle(unique_keys, randeng);
+
+    tree_t tree;
+    for (const auto& key : unique_keys) {
+        tree.insert(tree_t::value_type(key, 0));
+        ASSERT_EQ(tree.size(), tree.stats().leaf_nodes);
+    }
+    for (const auto& key : unique_keys) {
+        tree.erase(key);
+        ASSERT_EQ(tree.size(), tree.stats().leaf_nodes);
+    }
+}
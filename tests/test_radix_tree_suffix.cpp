@@ -0,0 +1,110 @@
+#include "common.hpp"
+
+#include <radix_tree_suffix.hpp>
+
+namespace {
+
+std::vector<radix_suffix_occurrence> occurrences(radix_suffix_index& index, const std::string& pattern) {
+    std::vector<radix_suffix_occurrence> found;
+    const std::size_t n = index.for_each_occurrence(
+        pattern, [&](const std::uint32_t id, const std::uint32_t offset) { found.push_back({id, offset}); });
+    EXPECT_EQ(found.size(), n);
+    std::ranges::sort(found, [](const radix_suffix_occurrence& a, const radix_suffix_occurrence& b) {
+        return a.id != b.id ? a.id < b.id : a.offset < b.offset;
+    });
+    return found;
+}
+
+} // namespace
+
+TEST(radix_suffix_index, substrings) {
+    radix_suffix_index index;
+    ASSERT_EQ(0u, index.add("banana"));
+    ASSERT_EQ(1u, index.add("bandana"));
+    ASSERT_EQ(2u, index.add(""));
+    ASSERT_EQ(3u, index.size());
+    ASSERT_EQ("bandana", index.text(1));
+
+    const std::vector<radix_suffix_occurrence> ana{{0, 1}, {0, 3}, {1, 4}};
+    ASSERT_EQ(ana, occurrences(index, "ana"));
+    ASSERT_EQ(2u, index.count_occurrences("ban"));
+    ASSERT_EQ(0u, index.count_occurrences("nab"));
+    ASSERT_EQ(13u, index.count_occurrences(""));
+
+    std::vector<radix_suffix_index::string_id> ids;
+    index.strings_containing("nd", ids);
+    ASSERT_EQ(std::vector<radix_suffix_index::string_id>{1}, ids);
+    index.strings_containing("an", ids);
+    ASSERT_EQ((std::vector<radix_suffix_index::string_id>{0, 1}), ids);
+    index.strings_containing("x", ids);
+    ASSERT_TRUE(ids.empty());
+
+    const radix_suffix_stats st = index.stats();
+    ASSERT_EQ(3u, st.strings);
+    ASSERT_EQ(13u, st.suffixes);
+    // "a", "ana" and "na" are shared
+    ASSERT_EQ(10u, st.distinct_suffixes);
+    ASSERT_GT(st.heap_bytes, st.tree.heap_bytes);
+}
+
+TEST(radix_suffix_index, against_brute_force) {
+    auto randeng = std::default_random_engine();
+    radix_suffix_index index;
+    std::vector<std::string> texts;
+    // one string at a time, then a batch, so that both add()s meet a tree that is not empty
+    for (int i = 0; i < 300; i++) {
+        texts.push_back(random_key(randeng, 20, 'c'));
+        index.add(texts.back());
+    }
+    std::vector<std::string> batch;
+    for (int i = 0; i < 1000; i++) {
+        batch.push_back(random_key(randeng, 20, 'c'));
+    }
+    ASSERT_EQ(300u, index.add(batch.begin(), batch.end()));
+    texts.insert(texts.end(), batch.begin(), batch.end());
+    // the index keeps its own copies
+    batch.clear();
+
+    for (int i = 0; i < 300; i++) {
+        const std::string pattern = random_key(randeng, 6, 'd');
+        std::vector<radix_suffix_occurrence> expected;
+        for (std::uint32_t id = 0; id < texts.size(); id++) {
+            for (std::size_t offset = texts[id].find(pattern); offset != std::string::npos && offset < texts[id].size();
+                 offset = texts[id].find(pattern, offset + 1)) {
+                expected.push_back({id, static_cast<std::uint32_t>(offset)});
+            }
+        }
+        ASSERT_EQ(expected, occurrences(index, pattern)) << pattern;
+    }
+}
+
+TEST(radix_suffix_index, stops_early) {
+    radix_suffix_index index;
+    for (const char* text : {"abab", "ab", "bab"}) {
+        index.add(text);
+    }
+
+    std::size_t seen = 0;
+    ASSERT_EQ(2u, index.for_each_occurrence("ab", [&](std::uint32_t, std::uint32_t) { return ++seen < 2; }));
+    ASSERT_EQ(2u, seen);
+}
+
+TEST(radix_suffix_index, string_longer_than_a_block) {
+    auto randeng = std::default_random_engine();
+    std::string big;
+    while (big.size() <= 64 * 1024) {
+        big += random_key(randeng, 100, 'z');
+    }
+
+    radix_suffix_index index;
+    index.add(std::string(1000, 'x'));
+    index.add(big);
+    // the strings after it must not be written into its block
+    index.add("hello");
+    index.add("world");
+
+    ASSERT_EQ(big, index.text(1));
+    ASSERT_EQ("hello", index.text(2));
+    ASSERT_EQ(1u, index.count_occurrences("hello"));
+    ASSERT_EQ(1u, index.count_occurrences(big.substr(40000, 20)));
+}
@@ -0,0 +1,144 @@
+#include "common.hpp"
+
+namespace {
+
+// a token and the value of its key, -1 for an unmatched byte
+using token = std::pair<std::string, int>;
+
+// the longest key at every position, by trying every length
+std::vector<token> reference_tokens(const std::map<std::string, int>& keys, const std::string& text,
+                                    const radix_unmatched unmatched) {
+    std::vector<token> tokens;
+    for (std::size_t i = 0; i < text.size();) {
+        std::size_t len = text.size() - i;
+        for (; len > 0 && !keys.contains(text.substr(i, len)); len--) {
+        }
+        if (len > 0) {
+            tokens.emplace_back(text.substr(i, len), keys.at(text.substr(i, len)));
+            i += len;
+            continue;
+        }
+        if (unmatched == radix_unmatched::stop) {
+            break;
+        }
+        if (unmatched == radix_unmatched::emit) {
+            tokens.emplace_back(text.substr(i, 1), -1);
+        }
+        i++;
+    }
+    return tokens;
+}
+
+auto collect(std::vector<token>& tokens) {
+    return [&tokens](const std::string_view text, tree_t::value_type* val) {
+        tokens.emplace_back(std::string(text), val != nullptr ? val->second : -1);
+        if (val != nullptr) {
+            EXPECT_EQ(val->first, text);
+        }
+    };
+}
+
+} // namespace
+
+TEST(tokenize, longest_keys) {
+    tree_t tree;
+    tree["a"] = 1;
+    tree["ab"] = 2;
+    tree["abcd"] = 3;
+    tree["bc"] = 4;
+    tree[""] = 5;
+
+    std::vector<token> tokens;
+    ASSERT_EQ(5u, tree.tokenize("abcabcdxbc", collect(tokens)));
+    const std::vector<token> expected{{"ab", 2}, {"c", -1}, {"abcd", 3}, {"x", -1}, {"bc", 4}};
+    ASSERT_EQ(expected, tokens);
+
+    tokens.clear();
+    ASSERT_EQ(3u, tree.tokenize("abcabcdxbc", collect(tokens), radix_unmatched::skip));
+    tokens.clear();
+    ASSERT_EQ(1u, tree.tokenize("abcabcdxbc", collect(tokens), radix_unmatched::stop));
+    ASSERT_EQ((std::vector<token>{{"ab", 2}}), tokens);
+
+    tree_t empty;
+    tokens.clear();
+    ASSERT_EQ(2u, empty.tokenize("ab", collect(tokens)));
+    ASSERT_EQ((std::vector<token>{{"a", -1}, {"b", -1}}), tokens);
+    ASSERT_EQ(0u, tree.tokenize("", collect(tokens)));
+}
+
+TEST(tokenize, against_brute_force) {
+    auto randeng = std::default_random_engine();
+    for (const int keys : {5, 50, 2000}) {
+        std::map<std::string, int> expected;
+        tree_t tree;
+        // the empty key is among them, and is never a token
+        insert_random_keys(tree, expected, randeng, keys, 7, 'd');
+
+        for (int i = 0; i < 30; i++) {
+            const std::string text = random_key(randeng, 300, 'e');
+            for (const auto unmatched : {radix_unmatched::emit, radix_unmatched::skip, radix_unmatched::stop}) {
+                std::vector<token> tokens;
+                tree.tokenize(text, collect(tokens), unmatched);
+                ASSERT_EQ(reference_tokens(expected, text, unmatched), tokens) << keys << " " << text;
+            }
+        }
+    }
+}
+
+TEST(tokenize, streams_across_buffers) {
+    auto randeng = std::default_random_engine();
+    std::map<std::string, int> expected;
+    tree_t tree;
+    insert_random_keys(tree, expected, randeng, 300, 10, 'c');
+    const std::string text = random_key(randeng, 4000, 'd');
+
+    for (const auto unmatched : {radix_unmatched::emit, radix_unmatched::skip, radix_unmatched::stop}) {
+        const std::vector<token> whole = reference_tokens(expected, text, unmatched);
+        for (const std::size_t chunk : {1u, 2u, 5u, 13u, 1000u, 5000u}) {
+            std::vector<token> tokens;
+            tree_t::tokenizer tokenizer(tree, unmatched);
+            std::size_t count = 0;
+            for (std::size_t pos = 0; pos < text.size(); pos += chunk) {
+                count += tokenizer.feed(std::string_view(text).substr(pos, chunk), collect(tokens));
+            }
+            count += tokenizer.finish(collect(tokens));
+            ASSERT_EQ(whole, tokens) << chunk;
+            ASSERT_EQ(tokens.size(), count);
+            ASSERT_EQ(unmatched == radix_unmatched::stop && text.find('d') != std::string::npos, tokenizer.stopped());
+        }
+    }
+}
+
+TEST(tokenize, stops_early) {
+    tree_t tree;
+    insert_unique_keys(tree);
+
+    std::vector<std::string> seen;
+    const auto until_bbb = [&](const std::string_view text, tree_t::value_type*) {
+        seen.emplace_back(text);
+        return text != "bbb";
+    };
+    ASSERT_EQ(2u, tree.tokenize("aaabbbab", until_bbb));
+    ASSERT_EQ((std::vector<std::string>{"aaa", "bbb"}), seen);
+
+    // a token held back at the end of a buffer ends the stream in the next one
+    seen.clear();
+    tree_t::tokenizer tokenizer(tree);
+    ASSERT_EQ(1u, tokenizer.feed("aaab", until_bbb));
+    ASSERT_EQ(1u, tokenizer.feed("bbab", until_bbb));
+    ASSERT_TRUE(tokenizer.stopped());
+    ASSERT_EQ(0u, tokenizer.feed("aa", until_bbb));
+    ASSERT_EQ(0u, tokenizer.finish(until_bbb));
+    ASSERT_EQ((std::vector<std::string>{"aaa", "bbb"}), seen);
+}
+
+TEST(tokenize, byte_vector_keys) {
+    radix_tree<std::vector<std::uint8_t>, int> tree;
+    tree[{0x00, 0xff}] = 1;
+    tree[{0xff}] = 2;
+
+    std::vector<int> found;
+    tree.tokenize(std::string_view("\x00\xff\xff\x01", 4),
+                  [&](std::string_view, auto* val) { found.push_back(val != nullptr ? val->second : -1); });
+    ASSERT_EQ((std::vector<int>{1, 2, -1}), found);
+}
@@ -0,0 +1,197 @@
+#include "common.hpp"
+
+namespace {
+
+using counted_tree_t = radix_tree<std::string, int, std::less<std::string>, radix_tree_counters>;
+
+double score_of(const tree_t::value_type& val) {
+    return val.second;
+}
+
+// the scores of the best k keys under a prefix, highest first
+std::vector<int> best_scores(const std::map<std::string, int>& expected, const std::string& prefix,
+                             const std::size_t k) {
+    std::vector<int> scores;
+    for (const auto& [key, value] : expected) {
+        if (key.starts_with(prefix)) {
+            scores.push_back(value);
+        }
+    }
+    std::ranges::sort(scores, std::greater<>());
+    scores.resize(std::min(scores.size(), k));
+    return scores;
+}
+
+template <class Tree>
+void assert_top_k(Tree& tree, const std::map<std::string, int>& expected, const std::string& prefix,
+                  const std::size_t k) {
+    std::vector<typename Tree::iterator> vec;
+    tree.top_k(prefix, k, vec);
+
+    std::vector<int> scores;
+    for (const auto& it : vec) {
+        ASSERT_TRUE(it->first.starts_with(prefix)) << it->first;
+        ASSERT_EQ(expected.at(it->first), it->second);
+        scores.push_back(it->second);
+    }
+    ASSERT_EQ(best_scores(expected, prefix, k), scores) << prefix << " " << k;
+}
+
+} // namespace
+
+TEST(top_k, against_brute_force) {
+    auto randeng = std::default_random_engine();
+    std::map<std::string, int> expected;
+    tree_t tree;
+    tree.enable_score_index(score_of);
+    for (int i = 0; i < 3000; i++) {
+        const std::string key = random_key(randeng, 8, 'd');
+        const int score = static_cast<int>(randeng() % 1000);
+        tree.insert({key, score});
+        expected.emplace(key, score);
+    }
+
+    for (int i = 0; i < 200; i++) {
+        const std::string prefix = random_key(randeng, 4, 'd');
+        for (const std::size_t k : {0u, 1u, 3u, 10u, 100u, 10000u}) {
+            assert_top_k(tree, expected, prefix, k);
+        }
+    }
+    assert_top_k(tree, expected, "e", 10);
+}
+
+TEST(top_k, kept_up_to_date) {
+    auto randeng = std::default_random_engine();
+    std::map<std::string, int> expected;
+    tree_t tree;
+    tree.enable_hash_index();
+    tree.enable_score_index(score_of);
+
+    for (int i = 0; i < 20000; i++) {
+        const std::string key = random_key(randeng, 7, 'd');
+        const int score = static_cast<int>(randeng() % 1000);
+        switch (randeng() % 4) {
+        case 0:
+            tree.erase(key);
+            expected.erase(key);
+            break;
+        case 1:
+            // a value changed in place
+            tree[key] = score;
+            tree.rescore(tree.find(key));
+            expected[key] = score;
+            break;
+        default:
+            tree.insert({key, score});
+            expected.emplace(key, score);
+            break;
+        }
+
+        if (i % 1000 == 0) {
+            tree.compact_step(200);
+        }
+        if (i % 50 == 0) {
+            assert_top_k(tree, expected, random_key(randeng, 3, 'd'), 5);
+        }
+    }
+    tree.compact();
+    assert_top_k(tree, expected, "", 50);
+    assert_top_k(tree, expected, "ab", 50);
+    ASSERT_GT(tree.stats().score_index_bytes, 0u);
+
+    for (const auto& [key, value] : expected) {
+        tree.erase(key);
+    }
+    std::vector<tree_t::iterator> vec;
+    tree.top_k("", 10, vec);
+    ASSERT_TRUE(vec.empty());
+
+    tree.clear();
+    tree["x"] = 3;
+    tree.top_k("", 10, vec);
+    ASSERT_EQ(1u, vec.size());
+}
+
+TEST(top_k, parallel_operations) {
+    auto randeng = std::default_random_engine();
+    std::map<std::string, int> expected;
+    std::vector<tree_t::value_type> values;
+    for (int i = 0; i < 20000; i++) {
+        const std::string key = random_key(randeng, 10, 'd');
+        const int score = static_cast<int>(randeng() % 100000);
+        if (expected.emplace(key, score).second) {
+            values.emplace_back(key, score);
+        }
+    }
+
+    tree_t tree;
+    tree.enable_score_index(score_of);
+    tree.build_parallel(values.begin(), values.end(), 4);
+    assert_top_k(tree, expected, "", 20);
+    assert_top_k(tree, expected, "c", 20);
+
+    std::vector<radix_mutation<std::string, int>> batch;
+    for (int i = 0; i < 5000; i++) {
+        const std::string key = random_key(randeng, 10, 'd');
+        const int score = static_cast<int>(randeng() % 200000);
+        if (i % 3 == 0) {
+            batch.push_back({radix_mutation_op::erase, key});
+            expected.erase(key);
+        } else {
+            batch.push_back({radix_mutation_op::assign, key, score});
+            expected[key] = score;
+        }
+    }
+    tree.apply_batch(batch, 4);
+    assert_top_k(tree, expected, "", 20);
+    assert_top_k(tree, expected, "da", 20);
+
+    // the serial path of apply_batch
+    batch.clear();
+    batch.push_back({radix_mutation_op::assign, values.front().first, 1000000});
+    expected[values.front().first] = 1000000;
+    tree.apply_batch(batch, 1);
+    assert_top_k(tree, expected, "", 3);
+}
+
+TEST(top_k, enabled_later) {
+    tree_t tree;
+    for (const auto& key : get_unique_keys()) {
+        tree[key] = static_cast<int>(key.size() * 10 + key.back());
+    }
+    tree.enable_score_index([](const tree_t::value_type& val) { return -val.second; });
+
+    std::vector<tree_t::iterator> vec;
+    tree.top_k("b", 3, vec);
+    ASSERT_EQ(3u, vec.size());
+    ASSERT_EQ("b", vec[0]->first);
+    ASSERT_EQ("ba", vec[1]->first);
+    ASSERT_EQ("bb", vec[2]->first);
+
+    tree.disable_score_index();
+    ASSERT_FALSE(tree.has_score_index());
+    tree.top_k("b", 3, vec);
+    ASSERT_TRUE(vec.empty());
+    tree.erase("b");
+    tree.enable_score_index([](const tree_t::value_type& val) { return -val.second; });
+    tree.top_k("b", 1, vec);
+    ASSERT_EQ("ba", vec[0]->first);
+}
+
+TEST(top_k, visits_few_nodes) {
+    auto randeng = std::default_random_engine();
+    counted_tree_t tree;
+    tree.enable_score_index([](const counted_tree_t::value_type& val) { return val.second; });
+    for (int i = 0; i < 50000; i++) {
+        tree[random_key(randeng, 12, 'd')] = static_cast<int>(randeng() % 1000000);
+    }
+    const auto st = tree.stats();
+
+    std::vector<counted_tree_t::iterator> vec;
+    tree.instrumentation().reset();
+    tree.top_k("", 10, vec);
+    ASSERT_EQ(10u, vec.size());
+    // no more than the paths to the ten best leaves
+    ASSERT_LE(tree.instrumentation().snapshot().node_visits, 10u * 13);
+    ASSERT_LT(tree.instrumentation().snapshot().node_visits * 100, st.internal_nodes);
+}
@@ -0,0 +1,337 @@
+// radix_tool: builds a radix_tree from a file, runs queries against it and reports what it cost.
+//
+// usage: radix_tool --data FILE [--queries FILE] [--op find|longest_match|prefix_match]
+//                   [--repeat N] [--write-image FILE]
+//
+// FILE has one key per line, optionally followed by a tab and a value. Sorted input is bulk loaded.
+// An image written by --write-image can be given back as --data.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <radix_tree.hpp>
+
+namespace {
+
+using tree_t = radix_tree<std::string, std::string>;
+using clock_type = std::chrono::steady_clock;
+
+// image format: the magic, the number of entries, then for every entry in key order the length of
+// the prefix shared with the previous key, the rest of the key and the value, each length as uint32
+constexpr char image_magic[8] = {'R', 'D', 'X', 'I', 'M', 'G', '0', '1'};
+
+class mapped_file {
+  public:
+    explicit mapped_file(const std::string& path) {
+        m_fd = open(path.c_str(), O_RDONLY);
+        if (m_fd < 0) {
+            std::perror(path.c_str());
+            return;
+        }
+        struct stat st {};
+        if (fstat(m_fd, &st) != 0) {
+            std::perror(path.c_str());
+            return;
+        }
+        m_size = static_cast<std::size_t>(st.st_size);
+        if (m_size == 0) {
+            m_ok = true;
+            return;
+        }
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+        if (data == MAP_FAILED) {
+            std::perror(path.c_str());
+            return;
+        }
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(data);
+        m_ok = true;
+    }
+
+    ~mapped_file() {
+        if (m_data != nullptr) {
+            munmap(const_cast<char*>(m_data), m_size);
+        }
+        if (m_fd >= 0) {
+            close(m_fd);
+        }
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    bool ok() const { return m_ok; }
+    std::string_view contents() const { return {m_data, m_size}; }
+
+  private:
+    int m_fd{-1};
+    const char* m_data{};
+    std::size_t m_size{};
+    bool m_ok{};
+};
+
+std::vector<std::string_view> split_lines(const std::string_view text) {
+    std::vector<std::string_view> lines;
+    std::size_t begin = 0;
+    while (begin < text.size()) {
+        std::size_t end = text.find('\n', begin);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string_view line = text.substr(begin, end - begin);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        lines.push_back(line);
+        begin = end + 1;
+    }
+    return lines;
+}
+
+bool is_image(const std::string_view text) {
+    return text.size() >= sizeof(image_magic) && std::memcmp(text.data(), image_magic, sizeof(image_magic)) == 0;
+}
+
+bool read_u32(std::string_view& in, std::uint32_t& out) {
+    if (in.size() < sizeof(out)) {
+        return false;
+    }
+    std::memcpy(&out, in.data(), sizeof(out));
+    in.remove_prefix(sizeof(out));
+    return true;
+}
+
+bool parse_image(std::string_view in, std::vector<std::pair<std::string, std::string>>& values) {
+    in.remove_prefix(sizeof(image_magic));
+    std::uint32_t count;
+    if (!read_u32(in, count)) {
+        return false;
+    }
+    std::string key;
+    for (std::uint32_t i = 0; i < count; i++) {
+        std::uint32_t shared, suffix_len, value_len;
+        if (!read_u32(in, shared) || !read_u32(in, suffix_len) || shared > key.size() || in.size() < suffix_len) {
+            return false;
+        }
+        key.resize(shared);
+        key.append(in.substr(0, suffix_len));
+        in.remove_prefix(suffix_len);
+        if (!read_u32(in, value_len) || in.size() < value_len) {
+            return false;
+        }
+        values.emplace_back(key, std::string(in.substr(0, value_len)));
+        in.remove_prefix(value_len);
+    }
+    return true;
+}
+
+void parse_lines(const std::string_view text, std::vector<std::pair<std::string, std::string>>& values) {
+    for (const std::string_view line : split_lines(text)) {
+        const std::size_t tab = line.find('\t');
+        if (tab == std::string_view::npos) {
+            values.emplace_back(std::string(line), std::string());
+        } else {
+            values.emplace_back(std::string(line.substr(0, tab)), std::string(line.substr(tab + 1)));
+        }
+    }
+}
+
+void write_u32(std::ofstream& out, const std::size_t value) {
+    const auto v = static_cast<std::uint32_t>(value);
+    out.write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+bool write_image(tree_t& tree, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(image_magic, sizeof(image_magic));
+    write_u32(out, tree.size());
+
+    std::string prev;
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+        const std::string& key = it->first;
+        const auto shared = static_cast<std::size_t>(std::ranges::mismatch(prev, key).in2 - key.begin());
+        write_u32(out, shared);
+        write_u32(out, key.size() - shared);
+        out.write(key.data() + shared, static_cast<std::streamsize>(key.size() - shared));
+        write_u32(out, it->second.size());
+        out.write(it->second.data(), static_cast<std::streamsize>(it->second.size()));
+        prev = key;
+    }
+    return static_cast<bool>(out);
+}
+
+double seconds(const clock_type::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+void print_stats(const radix_tree_stats& st, const std::size_t size) {
+    const auto per_key = [size](const std::size_t bytes) {
+        return size == 0 ? 0.0 : static_cast<double>(bytes) / static_cast<double>(size);
+    };
+    std::printf("nodes:              %zu internal, %zu leaf\n", st.internal_nodes, st.leaf_nodes);
+    std::printf("edge labels:        %zu elements, %zu bytes\n", st.edge_label_length, st.edge_label_bytes);
+    std::printf("duplicated labels:  %zu bytes\n", st.duplicated_key_bytes);
+    std::printf("values:             %zu bytes\n", st.value_bytes);
+    std::printf("estimated heap:     %zu bytes, %.1f bytes/key\n", st.heap_bytes, per_key(st.heap_bytes));
+
+    std::printf("fan-out:           ");
+    for (std::size_t i = 0; i < st.fanout.size(); i++) {
+        if (st.fanout[i] != 0) {
+            std::printf(" %zu%s:%zu", i, i + 1 == st.fanout.size() ? "+" : "", st.fanout[i]);
+        }
+    }
+    std::printf("\nleaf depth:        ");
+    for (std::size_t i = 0; i < st.depth.size(); i++) {
+        if (st.depth[i] != 0) {
+            std::printf(" %zu%s:%zu", i, i + 1 == st.depth.size() ? "+" : "", st.depth[i]);
+        }
+    }
+    std::printf("\n");
+}
+
+int usage() {
+    std::cerr << "usage: radix_tool --data FILE [--queries FILE] [--op find|longest_match|prefix_match]\n"
+                 "                  [--repeat N] [--write-image FILE]\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string data_path, queries_path, image_path, op = "find";
+    int repeat = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return usage();
+        }
+        if (arg == "--data") {
+            data_path = argv[++i];
+        } else if (arg == "--queries") {
+            queries_path = argv[++i];
+        } else if (arg == "--op") {
+            op = argv[++i];
+        } else if (arg == "--repeat") {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--write-image") {
+            image_path = argv[++i];
+        } else {
+            return usage();
+        }
+    }
+    if (data_path.empty() || (op != "find" && op != "longest_match" && op != "prefix_match")) {
+        return usage();
+    }
+
+    // load
+    std::vector<std::pair<std::string, std::string>> values;
+    {
+        const mapped_file data(data_path);
+        if (!data.ok()) {
+            return 1;
+        }
+        if (is_image(data.contents())) {
+            if (!parse_image(data.contents(), values)) {
+                std::cerr << data_path << ": corrupted image\n";
+                return 1;
+            }
+        } else {
+            parse_lines(data.contents(), values);
+        }
+    }
+
+    // build
+    const bool sorted = std::ranges::is_sorted(values, {}, [](const auto& kv) { return std::string_view(kv.first); });
+    tree_t tree;
+    const auto build_start = clock_type::now();
+    if (sorted) {
+        tree.insert(values.begin(), values.end());
+    } else {
+        for (const auto& kv : values) {
+            tree.insert(kv);
+        }
+    }
+    const double build_time = seconds(clock_type::now() - build_start);
+
+    std::printf("entries:            %zu read, %zu distinct, %s\n", values.size(), tree.size(),
+                sorted ? "sorted (bulk loaded)" : "unsorted");
+    std::printf("build:              %.3f s, %.0f inserts/s\n", build_time,
+                static_cast<double>(values.size()) / std::max(build_time, 1e-9));
+    values.clear();
+    values.shrink_to_fit();
+
+    print_stats(tree.stats(), tree.size());
+
+    // query
+    if (!queries_path.empty()) {
+        const mapped_file queries_file(queries_path);
+        if (!queries_file.ok()) {
+            return 1;
+        }
+        std::vector<std::string> queries;
+        for (const std::string_view line : split_lines(queries_file.contents())) {
+            queries.emplace_back(line);
+        }
+
+        std::vector<double> latencies;
+        latencies.reserve(queries.size() * static_cast<std::size_t>(repeat));
+        std::vector<tree_t::iterator> found_vec;
+        std::size_t found = 0;
+
+        const auto start = clock_type::now();
+        for (int r = 0; r < repeat; r++) {
+            for (const auto& query : queries) {
+                const auto t0 = clock_type::now();
+                if (op == "find") {
+                    found += tree.find(query) != tree.end() ? 1 : 0;
+                } else if (op == "longest_match") {
+                    found += tree.longest_match(query) != tree.end() ? 1 : 0;
+                } else {
+                    tree.prefix_match(query, found_vec);
+                    found += found_vec.size();
+                }
+                latencies.push_back(std::chrono::duration<double, std::nano>(clock_type::now() - t0).count());
+            }
+        }
+        const double total = seconds(clock_type::now() - start);
+
+        std::ranges::sort(latencies);
+        const auto percentile = [&latencies](const double p) {
+            if (latencies.empty()) {
+                return 0.0;
+            }
+            const auto idx = static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1));
+            return latencies[idx];
+        };
+
+        std::printf("%-20s%zu queries, %zu %s\n", (op + ":").c_str(), latencies.size(), found,
+                    op == "prefix_match" ? "results" : "hits");
+        std::printf("throughput:         %.0f queries/s\n", static_cast<double>(latencies.size()) / std::max(total, 1e-9));
+        std::printf("latency (ns):       p50 %.0f, p90 %.0f, p99 %.0f, p99.9 %.0f, max %.0f\n", percentile(0.5),
+                    percentile(0.9), percentile(0.99), percentile(0.999), percentile(1.0));
+    }
+
+    if (!image_path.empty()) {
+        if (!write_image(tree, image_path)) {
+            std::cerr << image_path << ": write failed\n";
+            return 1;
+        }
+        std::printf("image:              %s\n", image_path.c_str());
+    }
+
+    return 0;
+}